@@ -0,0 +1,205 @@
+#include "anytimeplanner.h"
+#include <algorithm>
+#include <cstdlib>
+
+AnytimePlanner::AnytimePlanner(double initialWeight, double weightStep)
+    : m_initialWeightPermille(std::max(1000, int(initialWeight * 1000 + 0.5)))
+    , m_weightStepPermille(std::max(1, int(weightStep * 1000 + 0.5)))
+{
+}
+
+int AnytimePlanner::heuristic(int index) const {
+    int width = m_map->width();
+    return std::abs(index % width - m_goal.x) + std::abs(index / width - m_goal.y);
+}
+
+void AnytimePlanner::touch(int index) {
+    if (m_g[index] == Infinity) {
+        m_touched.push_back(index);
+    }
+}
+
+void AnytimePlanner::begin(const GridMap &map, GridPoint start, GridPoint goal) {
+    m_metrics.clear();
+    PhaseTimer timer(m_metrics, SearchMetrics::Setup);
+    int cells = map.cellCount();
+    if (m_map && int(m_g.size()) == cells) {
+        // 同样大小的地图只需复位上一次查询写过的格子
+        for (int index : m_touched) {
+            m_g[index] = Infinity;
+            m_parent[index] = -1;
+            m_closedIteration[index] = 0;
+            m_inconsistent[index] = 0;
+        }
+    } else {
+        m_g.assign(size_t(cells), Infinity);
+        m_parent.assign(size_t(cells), -1);
+        m_closedIteration.assign(size_t(cells), 0);
+        m_inconsistent.assign(size_t(cells), 0);
+    }
+    m_touched.clear();
+    m_incons.clear();
+    m_open.reset(cells);
+
+    m_map = &map;
+    m_goal = goal;
+    m_weightPermille = m_initialWeightPermille;
+    m_iteration = 1;
+    m_completedIterations = 0;
+    m_expanded = 0;
+    m_result = PathResult();
+    m_bound = 0;
+
+    if (!map.isPassable(start.x, start.y) || !map.isPassable(goal.x, goal.y)) {
+        m_startIndex = m_goalIndex = -1;
+        m_finished = true;
+        return;
+    }
+    m_startIndex = map.index(start.x, start.y);
+    m_goalIndex = map.index(goal.x, goal.y);
+    touch(m_startIndex);
+    m_g[m_startIndex] = 0;
+    m_open.push(m_startIndex, key(m_startIndex));
+    m_metrics.push(m_open.size());
+    m_finished = false;
+}
+
+bool AnytimePlanner::improve(Clock::time_point deadline) {
+    bool finished;
+    {
+        PhaseTimer timer(m_metrics, SearchMetrics::Search);
+        finished = improveIterations(deadline);
+    }
+    m_result.metrics = m_metrics;
+    return finished;
+}
+
+bool AnytimePlanner::improveIterations(Clock::time_point deadline) {
+    bool firstPath = m_completedIterations == 0;
+    while (!m_finished) {
+        if (!improvePath(deadline, firstPath)) {
+            return false;
+        }
+        finishIteration();
+        firstPath = false;
+        if (!m_finished && Clock::now() >= deadline) {
+            return false;
+        }
+    }
+    return true;
+}
+
+PathResult AnytimePlanner::search(const GridMap &map, GridPoint start, GridPoint goal, std::chrono::microseconds budget) {
+    Clock::time_point deadline = Clock::now() + budget;
+    begin(map, start, goal);
+    improve(deadline);
+    return m_result;
+}
+
+bool AnytimePlanner::improvePath(Clock::time_point deadline, bool ignoreDeadline) {
+    static const int directions[4][2] = { {-1, 0}, {0, -1}, {0, 1}, {1, 0} };
+    int width = m_map->width();
+
+    // 开放集合中最小的键不小于终点的键时，这一轮的路径已满足当前权重下的上界
+    int expandedThisCall = 0;
+    while (!m_open.empty() && m_open.topKey() < key(m_goalIndex)) {
+        if (!ignoreDeadline && (++expandedThisCall & 255) == 0 && Clock::now() >= deadline) {
+            return false;
+        }
+
+        int current = m_open.pop();
+        m_closedIteration[current] = m_iteration;
+        ++m_expanded;
+        m_metrics.pop();
+        m_metrics.expand();
+
+        int x = current % width;
+        int y = current / width;
+        for (const auto &direction : directions) {
+            int nx = x + direction[0];
+            int ny = y + direction[1];
+            if (!m_map->isPassable(nx, ny)) {
+                continue;
+            }
+            int neighbor = m_map->index(nx, ny);
+            int tentativeG = m_g[current] + m_map->cost(neighbor);
+            if (tentativeG >= m_g[neighbor]) {
+                continue;
+            }
+
+            touch(neighbor);
+            m_g[neighbor] = tentativeG;
+            m_parent[neighbor] = current;
+            if (m_closedIteration[neighbor] != m_iteration) {
+                if (m_open.contains(neighbor)) {
+                    m_open.decreaseKey(neighbor, key(neighbor));
+                    m_metrics.decreaseKey();
+                } else {
+                    m_open.push(neighbor, key(neighbor));
+                    m_metrics.push(m_open.size());
+                }
+            } else if (!m_inconsistent[neighbor]) {
+                // 本轮已经关闭的节点不再重新扩展，留到下一轮
+                m_inconsistent[neighbor] = 1;
+                m_incons.push_back(neighbor);
+            }
+        }
+    }
+    return true;
+}
+
+void AnytimePlanner::finishIteration() {
+    ++m_completedIterations;
+    m_result.expanded = m_expanded;
+
+    int goalG = m_g[m_goalIndex];
+    if (goalG == Infinity) {
+        // 任何权重下开放集合耗尽都说明没有路径
+        m_result.found = false;
+        m_result.cost = 0;
+        m_result.path.clear();
+        m_bound = 0;
+        m_finished = true;
+        return;
+    }
+
+    m_result.found = true;
+    m_result.cost = goalG;
+    m_result.path.clear();
+    for (int index = m_goalIndex; index != -1; index = m_parent[index]) {
+        m_result.path.push_back({index % m_map->width(), index / m_map->width()});
+    }
+    std::reverse(m_result.path.begin(), m_result.path.end());
+
+    // 最优代价不小于 OPEN ∪ INCONS 中 g + h 的最小值
+    int lowerBound = goalG;
+    for (int index : m_touched) {
+        if (m_open.contains(index) || m_inconsistent[index]) {
+            lowerBound = std::min(lowerBound, m_g[index] + heuristic(index));
+        }
+    }
+    double ratio = lowerBound > 0 ? double(goalG) / lowerBound : 1.0;
+    m_bound = std::max(1.0, std::min(weight(), ratio));
+    if (m_weightPermille == 1000 || m_bound <= 1.0) {
+        m_bound = 1.0;
+        m_finished = true;
+        return;
+    }
+
+    // 降低权重，把不一致的节点并回开放集合，再按新权重重排所有键
+    m_weightPermille = std::max(1000, m_weightPermille - m_weightStepPermille);
+    for (int index : m_incons) {
+        m_inconsistent[index] = 0;
+        if (!m_open.contains(index)) {
+            m_open.push(index, key(index));
+            m_metrics.push(m_open.size());
+        }
+    }
+    m_incons.clear();
+    for (int index : m_touched) {
+        if (m_open.contains(index)) {
+            m_open.update(index, key(index));
+        }
+    }
+    ++m_iteration;
+}
@@ -0,0 +1,79 @@
+#ifndef ANYTIMEPLANNER_H
+#define ANYTIMEPLANNER_H
+
+#include "gridmap.h"
+#include "indexedheap.h"
+#include "pathengine.h"
+#include <chrono>
+#include <climits>
+#include <vector>
+
+// 随时可停的 ARA*：先用较大的权重 ε 做加权 A*，很快得到第一条路径，
+// 然后逐轮降低 ε，复用上一轮的 g 值只重新扩展不一致的节点，不断改进路径。
+// 每轮结束都给出当前路径代价与最优代价之比的上界，ε 降到 1 且上界为 1 时路径最优。
+// 四邻域，移动代价取地图的代价层，启发函数为曼哈顿距离。
+class AnytimePlanner {
+public:
+    using Clock = std::chrono::steady_clock;
+    static constexpr int Infinity = INT_MAX / 4;
+
+    explicit AnytimePlanner(double initialWeight = 3.0, double weightStep = 0.5);
+
+    // 开始新的查询，只初始化状态。地图在查询期间必须保持不变
+    void begin(const GridMap &map, GridPoint start, GridPoint goal);
+
+    // 在截止时间前继续改进。第一条路径不受截止时间限制，之后的一轮被截止时间打断时，
+    // 下次调用会从中断处继续。返回 true 表示路径已经最优或确定无路径，不必再调用
+    bool improve(Clock::time_point deadline);
+
+    // begin 加上一次 improve
+    PathResult search(const GridMap &map, GridPoint start, GridPoint goal, std::chrono::microseconds budget);
+
+    // 当前最好的路径；expanded 和 metrics 为所有轮次的累计值
+    const PathResult &result() const { return m_result; }
+    // 当前路径代价 / 最优代价 的上界，没有路径时为 0
+    double bound() const { return m_bound; }
+    double weight() const { return m_weightPermille / 1000.0; }
+    bool isFinished() const { return m_finished; }
+    int iterations() const { return m_completedIterations; }
+
+private:
+    bool improveIterations(Clock::time_point deadline);
+    // 加权 A* 的一轮；截止时间到达时返回 false，状态保留以便继续
+    bool improvePath(Clock::time_point deadline, bool ignoreDeadline);
+    // 一轮结束：记录路径和上界，然后降低权重、把不一致的节点放回开放集合
+    void finishIteration();
+
+    long long key(int index) const {
+        return (long long)m_g[index] * 1000 + (long long)heuristic(index) * m_weightPermille;
+    }
+    int heuristic(int index) const;
+    void touch(int index);
+
+    const GridMap *m_map = nullptr;
+    GridPoint m_goal;
+    int m_startIndex = -1;
+    int m_goalIndex = -1;
+
+    int m_initialWeightPermille;
+    int m_weightStepPermille;
+    int m_weightPermille = 1000;
+
+    std::vector<int> m_g;
+    std::vector<int> m_parent;
+    std::vector<int> m_closedIteration;   // 节点在第几轮被关闭，只比较是否等于当前轮次
+    std::vector<uint8_t> m_inconsistent;  // 已关闭后 g 值又被降低、等下一轮再扩展的节点
+    std::vector<int> m_incons;
+    std::vector<int> m_touched;           // g 值被写过的节点，统计上界和重排开放集合时只扫描它们
+    IndexedHeap<long long> m_open;
+    int m_iteration = 0;
+    int m_completedIterations = 0;
+    int m_expanded = 0;
+
+    PathResult m_result;
+    SearchMetrics m_metrics;
+    double m_bound = 0;
+    bool m_finished = true;
+};
+
+#endif // ANYTIMEPLANNER_H
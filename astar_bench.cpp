@@ -0,0 +1,586 @@
+// astar_bench：在 MovingAI 场景集上对每种算法计时，并用参考最优长度检查结果。
+// 结果以 JSON 输出，便于在两次构建之间比较。
+//
+//   astar_bench [选项] <场景文件.scen>...
+//     --neighborhood 4|8   移动模型，默认 8（与 MovingAI 的参考长度一致：斜行 √2，不能切墙角）
+//     --algorithms a,b,…   只运行列出的算法，默认除 cpd 以外的全部
+//     --repeat N           每个查询重复 N 次计时，默认 1；扩展节点数取第一次
+//     --weight W           weighted-astar 的权重，默认 1.5
+//     --landmarks K        astar-alt 的地标个数，默认 8
+//     --map 路径           所有场景共用这张地图（.map 或 .gmap），默认按场景里的地图名在场景文件旁查找
+//     --output 路径        JSON 写入文件，默认写到标准输出
+//
+// 八邻域的统一代价地图按场景文件里的最优长度检查；四邻域或带代价层的地图以不计时的 Dijkstra 结果为参考。
+// cpd（压缩路径数据库查表）的预处理与格子数的平方成正比，只在 --algorithms 里点名时运行。
+// 峰值内存是整个进程的峰值常驻内存，要单独测某个算法时用 --algorithms 只运行它。
+// 有查询未通过检查时退出码为 1，参数或文件错误时为 2。
+
+#include "anytimeplanner.h"
+#include "bidirectionalsearch.h"
+#include "hierarchicalpathfinder.h"
+#include "jumptable.h"
+#include "landmarks.h"
+#include "mapfile.h"
+#include "movingai.h"
+#include "pathdatabase.h"
+#include "pathengine.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// 参考长度只打印到小数点后 8 位，八邻域的斜行代价 99/70 又略大于 √2，比较时留一点相对误差
+const double kRelativeTolerance = 2e-4;
+const double kAbsoluteTolerance = 1e-6;
+
+struct Options {
+    int neighborhood = 8;
+    std::vector<std::string> algorithms;
+    int repeat = 1;
+    double weight = 1.5;
+    int landmarks = 8;
+    std::string mapPath;
+    std::string outputPath;
+    std::vector<std::string> scenarioPaths;
+};
+
+struct Query {
+    GridPoint start;
+    GridPoint goal;
+    double optimalLength = 0;
+};
+
+// 共用一张地图的查询，按第一次出现的顺序排列
+struct MapGroup {
+    std::string path;
+    int width = 0;
+    int height = 0;
+    std::vector<Query> queries;
+};
+
+// 对结果的要求：最优、代价不超过参考值的 bound 倍，或只检查路径是否合法
+enum class Check {
+    Optimal,
+    Bounded,
+    None
+};
+
+struct Runner {
+    std::string name;
+    Check check = Check::Optimal;
+    double bound = 1.0;
+    bool onlyOnRequest = false;                     // 预处理太慢，不在默认的算法列表里
+    std::function<void(const GridMap &)> prepare;   // 每张地图一次的预处理，单独计时
+    std::function<PathResult(const GridMap &, GridPoint, GridPoint)> query;
+};
+
+struct AlgorithmStats {
+    long long queries = 0;
+    long long found = 0;
+    long long failures = 0;
+    long long expanded = 0;
+    double preprocessMs = 0;
+    double ratioSum = 0;
+    double maxRatio = 0;
+    long long ratioCount = 0;
+    SearchMetrics metrics;   // 每个查询第一次运行的计数之和
+    std::vector<double> latenciesUs;
+};
+
+long long peakMemoryBytes() {
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS counters;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+        return (long long)counters.PeakWorkingSetSize;
+    }
+    return 0;
+#else
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) {
+        return 0;
+    }
+#ifdef __APPLE__
+    return (long long)usage.ru_maxrss;
+#else
+    return (long long)usage.ru_maxrss * 1024;
+#endif
+#endif
+}
+
+double elapsedMs(Clock::time_point since) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - since).count();
+}
+
+std::string jsonString(const std::string &text) {
+    std::string out = "\"";
+    for (char c : text) {
+        if (c == '"' || c == '\\') {
+            out += '\\';
+            out += c;
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            char escaped[8];
+            std::snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+            out += escaped;
+        } else {
+            out += c;
+        }
+    }
+    return out + "\"";
+}
+
+std::string jsonNumber(double value) {
+    char text[32];
+    std::snprintf(text, sizeof(text), "%.6g", value);
+    return text;
+}
+
+// 最近秩百分位；latencies 必须已排序
+double percentile(const std::vector<double> &latencies, double p) {
+    if (latencies.empty()) {
+        return 0;
+    }
+    size_t rank = size_t(std::ceil(p * double(latencies.size())));
+    return latencies[rank > 0 ? rank - 1 : 0];
+}
+
+std::string directoryOf(const std::string &path) {
+    size_t slash = path.find_last_of("/\\");
+    return slash == std::string::npos ? std::string() : path.substr(0, slash + 1);
+}
+
+bool fileExists(const std::string &path) {
+    return std::ifstream(path).good();
+}
+
+bool endsWith(const std::string &text, const std::string &suffix) {
+    return text.size() >= suffix.size() && text.compare(text.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+bool loadAnyMap(const std::string &path, GridMap &map, std::string &error) {
+    return endsWith(path, MapFile::Extension) ? MapFile::open(path, map, &error) : MovingAi::loadMap(path, map, &error);
+}
+
+// 场景里的地图名可能带目录，依次尝试场景文件旁的完整相对路径、只取文件名、原样
+std::string resolveMapPath(const std::string &scenarioPath, const std::string &mapName) {
+    std::string directory = directoryOf(scenarioPath);
+    size_t slash = mapName.find_last_of("/\\");
+    std::string baseName = slash == std::string::npos ? mapName : mapName.substr(slash + 1);
+    for (const std::string &candidate : { directory + mapName, directory + baseName, mapName }) {
+        if (fileExists(candidate)) {
+            return candidate;
+        }
+    }
+    return directory + mapName;
+}
+
+// 检查路径首尾、相邻两点在邻域内可走，并累计几何长度（直行 1，斜行 √2）
+template <typename Neighborhood>
+bool validatePath(const GridMap &map, const std::vector<GridPoint> &path, GridPoint start, GridPoint goal, double &length) {
+    length = 0;
+    if (path.empty() || path.front() != start || path.back() != goal) {
+        return false;
+    }
+    for (size_t i = 1; i < path.size(); ++i) {
+        int dx = path[i].x - path[i - 1].x;
+        int dy = path[i].y - path[i - 1].y;
+        bool diagonal = dx != 0 && dy != 0;
+        if (std::abs(dx) > 1 || std::abs(dy) > 1 || (dx == 0 && dy == 0) || (diagonal && !Neighborhood::AllowsDiagonal)
+            || !map.isPassable(path[i].x, path[i].y)
+            || !Neighborhood::canMove(map, path[i - 1].x, path[i - 1].y, dx, dy)) {
+            return false;
+        }
+        length += diagonal ? std::sqrt(2.0) : 1.0;
+    }
+    return true;
+}
+
+template <typename Heuristic, typename Neighborhood>
+std::vector<Runner> makeRunners(double weight, int landmarkCount) {
+    using Context = BasicSearchContext<Heuristic, Neighborhood>;
+    using Bidirectional = BasicBidirectionalContext<Heuristic, Neighborhood>;
+    std::vector<Runner> runners;
+
+    // 每个算法持有自己的上下文，查询之间复用内存，与后台服务的用法一致
+    auto addSearch = [&](const std::string &name, Algorithm algorithm, Check check, double searchWeight) {
+        auto context = std::make_shared<Context>();
+        context->setHeuristicWeight(searchWeight);
+        Runner runner;
+        runner.name = name;
+        runner.check = check;
+        runner.bound = searchWeight;
+        runner.query = [context, algorithm](const GridMap &map, GridPoint start, GridPoint goal) {
+            return findPath(*context, map, start, goal, algorithm);
+        };
+        runners.push_back(runner);
+    };
+    auto addBidirectional = [&](const std::string &name, Algorithm algorithm) {
+        auto context = std::make_shared<Bidirectional>();
+        Runner runner;
+        runner.name = name;
+        runner.query = [context, algorithm](const GridMap &map, GridPoint start, GridPoint goal) {
+            return findPath(*context, map, start, goal, algorithm);
+        };
+        runners.push_back(runner);
+    };
+
+    addSearch("dijkstra", Algorithm::Dijkstra, Check::Optimal, 1.0);
+    addSearch("astar", Algorithm::AStar, Check::Optimal, 1.0);
+    addSearch("weighted-astar", Algorithm::AStar, Check::Bounded, weight);
+    addSearch("greedy", Algorithm::Greedy, Check::None, 1.0);
+
+    // 地标表按地图预计算，构建时间计入 preprocessMs
+    auto landmarks = std::make_shared<LandmarkTable>();
+    auto landmarkContext = std::make_shared<Context>();
+    Runner alt;
+    alt.name = "astar-alt";
+    alt.prepare = [landmarks, landmarkContext, landmarkCount](const GridMap &map) {
+        std::string error;
+        if (!landmarks->build<Neighborhood>(map, landmarkCount, &error)) {
+            std::cerr << "astar-alt runs without landmarks: " << error << std::endl;
+        }
+        landmarkContext->setLandmarks(landmarks.get());
+    };
+    alt.query = [landmarkContext](const GridMap &map, GridPoint start, GridPoint goal) {
+        return findPath(*landmarkContext, map, start, goal, Algorithm::AStar);
+    };
+    runners.push_back(alt);
+
+    // 每个起点一遍 Dijkstra 的全对全预处理，查询只查表
+    auto database = std::make_shared<PathDatabase>();
+    Runner cpd;
+    cpd.name = "cpd";
+    cpd.onlyOnRequest = true;
+    cpd.prepare = [database](const GridMap &map) { database->build<Neighborhood>(map); };
+    cpd.query = [database](const GridMap &map, GridPoint start, GridPoint goal) {
+        return database->findPath<Neighborhood>(map, start, goal);
+    };
+    runners.push_back(cpd);
+
+    addBidirectional("bidirectional-dijkstra", Algorithm::Dijkstra);
+    addBidirectional("bidirectional-astar", Algorithm::AStar);
+
+    // 跳点搜索、JPS+、HPA* 和 ARA* 只支持四邻域
+    if (!Neighborhood::AllowsDiagonal) {
+        addSearch("jps", Algorithm::JumpPoint, Check::Optimal, 1.0);
+
+        auto table = std::make_shared<JumpTable>();
+        auto tableContext = std::make_shared<Context>();
+        Runner jpsPlus;
+        jpsPlus.name = "jps-plus";
+        jpsPlus.prepare = [table, tableContext](const GridMap &map) {
+            table->build(map);
+            tableContext->setJumpTable(table.get());
+        };
+        jpsPlus.query = [tableContext](const GridMap &map, GridPoint start, GridPoint goal) {
+            return findPath(*tableContext, map, start, goal, Algorithm::JumpPoint);
+        };
+        runners.push_back(jpsPlus);
+
+        auto hierarchy = std::make_shared<HierarchicalPathfinder>();
+        Runner hpa;
+        hpa.name = "hpa";
+        hpa.check = Check::None;
+        hpa.prepare = [hierarchy](const GridMap &map) { hierarchy->build(map); };
+        hpa.query = [hierarchy](const GridMap &, GridPoint start, GridPoint goal) {
+            return hierarchy->findPath(start, goal);
+        };
+        runners.push_back(hpa);
+
+        // 预算足够长，一直改进到最优，计时包含所有轮次
+        auto planner = std::make_shared<AnytimePlanner>();
+        Runner ara;
+        ara.name = "ara";
+        ara.query = [planner](const GridMap &map, GridPoint start, GridPoint goal) {
+            return planner->search(map, start, goal, std::chrono::hours(1));
+        };
+        runners.push_back(ara);
+    }
+    return runners;
+}
+
+bool parseOptions(int argc, char *argv[], Options &options) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--neighborhood" && hasValue) {
+            options.neighborhood = std::atoi(argv[++i]);
+        } else if (arg == "--algorithms" && hasValue) {
+            std::stringstream names(argv[++i]);
+            std::string name;
+            while (std::getline(names, name, ',')) {
+                if (!name.empty()) {
+                    options.algorithms.push_back(name);
+                }
+            }
+        } else if (arg == "--repeat" && hasValue) {
+            options.repeat = std::atoi(argv[++i]);
+        } else if (arg == "--weight" && hasValue) {
+            options.weight = std::atof(argv[++i]);
+        } else if (arg == "--landmarks" && hasValue) {
+            options.landmarks = std::atoi(argv[++i]);
+        } else if (arg == "--map" && hasValue) {
+            options.mapPath = argv[++i];
+        } else if (arg == "--output" && hasValue) {
+            options.outputPath = argv[++i];
+        } else if (!arg.empty() && arg[0] == '-') {
+            return false;
+        } else {
+            options.scenarioPaths.push_back(arg);
+        }
+    }
+    return (options.neighborhood == 4 || options.neighborhood == 8) && options.repeat > 0
+        && options.weight >= 1.0 && options.landmarks >= 1 && options.landmarks <= LandmarkTable::MaxLandmarks
+        && !options.scenarioPaths.empty();
+}
+
+bool loadGroups(const Options &options, std::vector<MapGroup> &groups, std::string &error) {
+    std::map<std::string, size_t> groupOfMap;
+    for (const std::string &scenarioPath : options.scenarioPaths) {
+        std::vector<MovingAi::Scenario> scenarios;
+        if (!MovingAi::loadScenarios(scenarioPath, scenarios, &error)) {
+            return false;
+        }
+        for (const MovingAi::Scenario &scenario : scenarios) {
+            std::string mapPath = options.mapPath.empty() ? resolveMapPath(scenarioPath, scenario.mapName) : options.mapPath;
+            auto found = groupOfMap.find(mapPath);
+            if (found == groupOfMap.end()) {
+                found = groupOfMap.emplace(mapPath, groups.size()).first;
+                groups.push_back({ mapPath, scenario.mapWidth, scenario.mapHeight, {} });
+            }
+            groups[found->second].queries.push_back({ scenario.start, scenario.goal, scenario.optimalLength });
+        }
+    }
+    return true;
+}
+
+template <typename Heuristic, typename Neighborhood>
+int runBenchmark(const Options &options, const std::vector<MapGroup> &groups, std::ostream &out) {
+    std::vector<Runner> runners = makeRunners<Heuristic, Neighborhood>(options.weight, options.landmarks);
+    if (options.algorithms.empty()) {
+        runners.erase(std::remove_if(runners.begin(), runners.end(), [](const Runner &runner) { return runner.onlyOnRequest; }),
+                      runners.end());
+    } else {
+        std::vector<Runner> selected;
+        for (const std::string &name : options.algorithms) {
+            auto found = std::find_if(runners.begin(), runners.end(), [&](const Runner &runner) { return runner.name == name; });
+            if (found == runners.end()) {
+                std::cerr << "unknown algorithm for this neighborhood: " << name << std::endl;
+                return 2;
+            }
+            selected.push_back(*found);
+        }
+        runners = selected;
+    }
+
+    std::vector<AlgorithmStats> stats(runners.size());
+    BasicSearchContext<Heuristic, Neighborhood> referenceContext;
+    long long queryCount = 0;
+    double loadMs = 0;
+
+    for (const MapGroup &group : groups) {
+        GridMap map;
+        std::string error;
+        Clock::time_point loadStart = Clock::now();
+        if (!loadAnyMap(group.path, map, error)) {
+            std::cerr << error << std::endl;
+            return 2;
+        }
+        loadMs += elapsedMs(loadStart);
+        if (options.mapPath.empty() && (map.width() != group.width || map.height() != group.height)) {
+            std::cerr << group.path << " does not match the size given in the scenario file" << std::endl;
+            return 2;
+        }
+
+        // 参考值以路径长度为单位：场景文件给出的长度，或 Dijkstra 代价除以直行代价；负数表示无路可走
+        bool useScenarioLength = Neighborhood::AllowsDiagonal && !map.hasCosts();
+        std::vector<double> references;
+        for (const Query &query : group.queries) {
+            if (!map.isPassable(query.start.x, query.start.y) || !map.isPassable(query.goal.x, query.goal.y)) {
+                std::cerr << group.path << ": scenario endpoint is outside the map or blocked" << std::endl;
+                return 2;
+            }
+            if (useScenarioLength) {
+                references.push_back(query.optimalLength);
+            } else {
+                PathResult reference = findPath(referenceContext, map, query.start, query.goal, Algorithm::Dijkstra);
+                references.push_back(reference.found ? double(reference.cost) / Neighborhood::StraightCost : -1.0);
+            }
+        }
+        queryCount += (long long)group.queries.size();
+
+        for (size_t r = 0; r < runners.size(); ++r) {
+            const Runner &runner = runners[r];
+            AlgorithmStats &stat = stats[r];
+            if (runner.prepare) {
+                Clock::time_point prepareStart = Clock::now();
+                runner.prepare(map);
+                stat.preprocessMs += elapsedMs(prepareStart);
+            }
+
+            for (size_t q = 0; q < group.queries.size(); ++q) {
+                const Query &query = group.queries[q];
+                PathResult result;
+                for (int k = 0; k < options.repeat; ++k) {
+                    Clock::time_point queryStart = Clock::now();
+                    PathResult run = runner.query(map, query.start, query.goal);
+                    stat.latenciesUs.push_back(std::chrono::duration<double, std::micro>(Clock::now() - queryStart).count());
+                    if (k == 0) {
+                        result = std::move(run);
+                    }
+                }
+                ++stat.queries;
+                stat.expanded += result.expanded;
+                stat.metrics.merge(result.metrics);
+
+                double reference = references[q];
+                if (!result.found) {
+                    stat.failures += reference >= 0 ? 1 : 0;
+                    continue;
+                }
+                ++stat.found;
+                double length = 0;
+                if (reference < 0 || !validatePath<Neighborhood>(map, result.path, query.start, query.goal, length)) {
+                    ++stat.failures;
+                    continue;
+                }
+                double measured = useScenarioLength ? length : double(result.cost) / Neighborhood::StraightCost;
+                double slack = reference * kRelativeTolerance + kAbsoluteTolerance;
+                bool tooShort = measured < reference - slack;
+                bool tooLong = (runner.check == Check::Optimal && measured > reference + slack)
+                            || (runner.check == Check::Bounded && measured > reference * runner.bound + slack);
+                if (tooShort || tooLong) {
+                    ++stat.failures;
+                }
+                if (reference > 0) {
+                    double ratio = measured / reference;
+                    stat.ratioSum += ratio;
+                    stat.maxRatio = std::max(stat.maxRatio, ratio);
+                    ++stat.ratioCount;
+                }
+            }
+        }
+    }
+
+    long long totalFailures = 0;
+    out << "{\n";
+    out << "  \"benchmark\": \"astar_bench\",\n";
+#if defined(_MSC_VER)
+    out << "  \"compiler\": " << jsonString("MSVC " + std::to_string(_MSC_VER)) << ",\n";
+#elif defined(__VERSION__)
+    out << "  \"compiler\": " << jsonString(__VERSION__) << ",\n";
+#endif
+#ifdef NDEBUG
+    out << "  \"assertions\": false,\n";
+#else
+    out << "  \"assertions\": true,\n";
+#endif
+    out << "  \"neighborhood\": " << options.neighborhood << ",\n";
+    out << "  \"repeat\": " << options.repeat << ",\n";
+    out << "  \"scenarioFiles\": [";
+    for (size_t i = 0; i < options.scenarioPaths.size(); ++i) {
+        out << (i ? ", " : "") << jsonString(options.scenarioPaths[i]);
+    }
+    out << "],\n";
+    out << "  \"maps\": " << groups.size() << ",\n";
+    out << "  \"queries\": " << queryCount << ",\n";
+    out << "  \"mapLoadMs\": " << jsonNumber(loadMs) << ",\n";
+    out << "  \"algorithms\": [\n";
+    for (size_t r = 0; r < runners.size(); ++r) {
+        AlgorithmStats &stat = stats[r];
+        std::sort(stat.latenciesUs.begin(), stat.latenciesUs.end());
+        double totalUs = 0;
+        for (double latency : stat.latenciesUs) {
+            totalUs += latency;
+        }
+        totalFailures += stat.failures;
+        const char *check = runners[r].check == Check::Optimal ? "optimal" : runners[r].check == Check::Bounded ? "bounded" : "none";
+
+        out << "    {\n";
+        out << "      \"name\": " << jsonString(runners[r].name) << ",\n";
+        out << "      \"check\": \"" << check << "\",\n";
+        if (runners[r].check == Check::Bounded) {
+            out << "      \"bound\": " << jsonNumber(runners[r].bound) << ",\n";
+        }
+        out << "      \"queries\": " << stat.queries << ",\n";
+        out << "      \"found\": " << stat.found << ",\n";
+        out << "      \"failures\": " << stat.failures << ",\n";
+        out << "      \"nodesExpanded\": " << stat.expanded << ",\n";
+        out << "      \"meanNodesExpanded\": " << jsonNumber(stat.queries ? double(stat.expanded) / stat.queries : 0) << ",\n";
+        out << "      \"queriesPerSecond\": " << jsonNumber(totalUs > 0 ? stat.latenciesUs.size() * 1e6 / totalUs : 0) << ",\n";
+        out << "      \"latencyUs\": { \"p50\": " << jsonNumber(percentile(stat.latenciesUs, 0.50))
+            << ", \"p99\": " << jsonNumber(percentile(stat.latenciesUs, 0.99))
+            << ", \"max\": " << jsonNumber(stat.latenciesUs.empty() ? 0 : stat.latenciesUs.back()) << " },\n";
+        if (SearchMetrics::Enabled) {
+            out << "      \"pushes\": " << stat.metrics.pushes << ",\n";
+            out << "      \"pops\": " << stat.metrics.pops << ",\n";
+            out << "      \"decreaseKeys\": " << stat.metrics.decreaseKeys << ",\n";
+            out << "      \"stalePops\": " << stat.metrics.stalePops << ",\n";
+            out << "      \"peakOpenSize\": " << stat.metrics.peakOpenSize << ",\n";
+        }
+        out << "      \"meanLengthRatio\": " << jsonNumber(stat.ratioCount ? stat.ratioSum / stat.ratioCount : 0) << ",\n";
+        out << "      \"maxLengthRatio\": " << jsonNumber(stat.maxRatio) << ",\n";
+        out << "      \"preprocessMs\": " << jsonNumber(stat.preprocessMs) << "\n";
+        out << "    }" << (r + 1 < runners.size() ? "," : "") << "\n";
+    }
+    out << "  ],\n";
+    out << "  \"failures\": " << totalFailures << ",\n";
+    out << "  \"peakMemoryBytes\": " << peakMemoryBytes() << "\n";
+    out << "}\n";
+    return totalFailures > 0 ? 1 : 0;
+}
+
+}
+
+int main(int argc, char *argv[]) {
+    Options options;
+    if (!parseOptions(argc, argv, options)) {
+        std::cerr << "usage: astar_bench [--neighborhood 4|8] [--algorithms a,b,...] [--repeat N] [--weight W]\n"
+                     "                   [--landmarks K] [--map file] [--output file] scenario.scen..." << std::endl;
+        return 2;
+    }
+
+    std::vector<MapGroup> groups;
+    std::string error;
+    if (!loadGroups(options, groups, error)) {
+        std::cerr << error << std::endl;
+        return 2;
+    }
+
+    std::ofstream file;
+    if (!options.outputPath.empty()) {
+        file.open(options.outputPath);
+        if (!file) {
+            std::cerr << "cannot create " << options.outputPath << std::endl;
+            return 2;
+        }
+    }
+    std::ostream &out = options.outputPath.empty() ? std::cout : file;
+
+    if (options.neighborhood == 4) {
+        return runBenchmark<Manhattan, FourConnected>(options, groups, out);
+    }
+    return runBenchmark<Octile, EightConnected<CornerRule::NoCutCorners>>(options, groups, out);
+}
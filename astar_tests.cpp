@@ -0,0 +1,368 @@
+// astar_tests：搜索引擎的回归检查，由 ctest 运行（见 CMakeLists.txt 里的 add_test）。
+//
+//   astar_tests [检查名]...   不给名字时运行全部检查
+//
+// 每项检查在标准输出打印未通过的细节和一行汇总；有检查未通过时退出码为 1，名字不认识时为 2。
+// 随机输入用固定种子生成，失败可以复现。
+
+#include "bidirectionalsearch.h"
+#include "componentindex.h"
+#include "landmarks.h"
+#include "mapfile.h"
+#include "pathengine.h"
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct Check {
+    const char *name;
+    std::function<int()> run;   // 返回未通过的次数
+};
+
+// 每项检查最多打印这么多条失败，其余只计数
+const int kReportedFailures = 5;
+
+std::ostream &operator<<(std::ostream &out, GridPoint point) {
+    return out << "(" << point.x << ", " << point.y << ")";
+}
+
+const char *algorithmName(Algorithm algorithm) {
+    switch (algorithm) {
+    case Algorithm::Dijkstra: return "dijkstra";
+    case Algorithm::Greedy: return "greedy";
+    case Algorithm::AStar: return "astar";
+    case Algorithm::JumpPoint: return "jps";
+    }
+    return "?";
+}
+
+// 随机地图：尺寸 1..maxSide，障碍物比例 0~45%，一半的地图带 1~9 的通行代价
+GridMap randomMap(std::mt19937 &random, int maxSide) {
+    std::uniform_int_distribution<int> side(1, maxSide);
+    GridMap map(side(random), side(random));
+    double density = std::uniform_real_distribution<double>(0.0, 0.45)(random);
+    bool costs = random() % 2 == 0;
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    for (int y = 0; y < map.height(); ++y) {
+        for (int x = 0; x < map.width(); ++x) {
+            if (unit(random) < density) {
+                map.setObstacle(x, y, true);
+            } else if (costs) {
+                map.setCost(x, y, 1 + int(random() % 9));
+            }
+        }
+    }
+    return map;
+}
+
+GridPoint randomPoint(std::mt19937 &random, const GridMap &map) {
+    return { int(random() % unsigned(map.width())), int(random() % unsigned(map.height())) };
+}
+
+// 同一个上下文反复使用时，每次查询的结果都要与新建的上下文完全一致：
+// 是否找到、代价、路径和扩展的节点数。components 为空表示不挂连通分量索引
+template <typename Context>
+class ReuseChecker {
+public:
+    explicit ReuseChecker(const char *name) : m_name(name) {}
+
+    void query(const GridMap &map, const ComponentIndex *components, GridPoint start, GridPoint goal,
+               Algorithm algorithm, int &failures) {
+        m_reused.setComponentIndex(components);
+        PathResult reused = findPath(m_reused, map, start, goal, algorithm);
+        Context fresh;
+        fresh.setComponentIndex(components);
+        PathResult expected = findPath(fresh, map, start, goal, algorithm);
+        ++m_queries;
+        if (reused.found == expected.found && reused.cost == expected.cost && reused.path == expected.path
+            && reused.expanded == expected.expanded) {
+            return;
+        }
+        if (failures++ < kReportedFailures) {
+            std::cout << m_name << " " << algorithmName(algorithm) << " on " << map.width() << "x" << map.height()
+                      << (components ? " with component index" : "") << ", query " << m_queries << " " << start
+                      << " -> " << goal << ": reused found=" << reused.found << " cost=" << reused.cost
+                      << " expanded=" << reused.expanded << ", fresh found=" << expected.found << " cost="
+                      << expected.cost << " expanded=" << expected.expanded << std::endl;
+        }
+    }
+
+private:
+    const char *m_name;
+    Context m_reused;
+    int m_queries = 0;
+};
+
+// 复用的上下文经过尺寸各异的地图、各种算法和被连通分量索引拒绝的查询，结果必须与新建的一致
+int checkContextReuse() {
+    std::mt19937 random(20240611);
+    ReuseChecker<BasicSearchContext<Manhattan, FourConnected>> fourWay("search-4");
+    ReuseChecker<BucketSearchContext> bucket("bucket-4");
+    ReuseChecker<BasicSearchContext<Octile, EightConnected<>>> eightWay("search-8");
+    ReuseChecker<BasicSearchContext<Octile, EightConnected<CornerRule::CutCorners>>> cutCorners("search-8-cut");
+    ReuseChecker<BasicBidirectionalContext<Manhattan, FourConnected>> bidirectional("bidirectional-4");
+    ReuseChecker<BasicBidirectionalContext<Octile, EightConnected<>>> bidirectionalEight("bidirectional-8");
+    ReuseChecker<BasicBidirectionalContext<Octile, EightConnected<CornerRule::CutCorners>>> bidirectionalCut("bidirectional-8-cut");
+
+    const Algorithm searchAlgorithms[] = { Algorithm::Dijkstra, Algorithm::Greedy, Algorithm::AStar, Algorithm::JumpPoint };
+    const Algorithm bidirectionalAlgorithms[] = { Algorithm::Dijkstra, Algorithm::AStar };
+    int failures = 0;
+    for (int round = 0; round < 200; ++round) {
+        GridMap map = randomMap(random, round % 4 == 0 ? 64 : 24);
+        ComponentIndex orthogonal(map, ComponentIndex::Orthogonal);
+        ComponentIndex diagonal(map, ComponentIndex::Diagonal);
+        for (int i = 0; i < 8; ++i) {
+            GridPoint start = randomPoint(random, map);
+            GridPoint goal = randomPoint(random, map);
+            // 约一半的查询挂上索引，不连通的端点在这里被拒绝，复用的上下文不重置网格
+            bool useIndex = random() % 2 == 0;
+            const ComponentIndex *straight = useIndex ? &orthogonal : nullptr;
+            const ComponentIndex *cut = useIndex ? &diagonal : nullptr;
+            Algorithm search = searchAlgorithms[random() % 4];
+            Algorithm both = bidirectionalAlgorithms[random() % 2];
+
+            fourWay.query(map, straight, start, goal, search, failures);
+            bucket.query(map, straight, start, goal, search, failures);
+            eightWay.query(map, straight, start, goal, search, failures);
+            cutCorners.query(map, cut, start, goal, search, failures);
+            bidirectional.query(map, straight, start, goal, both, failures);
+            bidirectionalEight.query(map, straight, start, goal, both, failures);
+            bidirectionalCut.query(map, cut, start, goal, both, failures);
+        }
+    }
+    return failures;
+}
+
+// 被连通分量索引拒绝的查询之后的复用：同一个上下文先在 20x20 的地图上搜索，再跑一次被拒绝、
+// 尺寸不同的查询，最后在这个尺寸的地图上正常搜索。拒绝查询只在尺寸不符时重新分配网格，
+// 双向搜索曾因此留下上次关闭的节点，两侧在残留的值上相遇，返回代价 14 而不是 18 的路径
+template <typename Context>
+int checkRejectedThenReused(const char *name) {
+    GridMap large(20, 20);
+    GridMap walled(10, 10);
+    for (int y = 0; y < walled.height(); ++y) {
+        walled.setObstacle(5, y, true);
+    }
+    ComponentIndex components(walled);
+    GridMap open(10, 10);
+    GridPoint start{0, 0};
+    GridPoint goal{9, 9};
+
+    int failures = 0;
+    for (Algorithm algorithm : { Algorithm::Dijkstra, Algorithm::AStar }) {
+        Context reused;
+        findPath(reused, large, start, { 19, 19 }, algorithm);
+        reused.setComponentIndex(&components);
+        PathResult rejected = findPath(reused, walled, start, goal, algorithm);
+        reused.setComponentIndex(nullptr);
+        PathResult result = findPath(reused, open, start, goal, algorithm);
+
+        Context fresh;
+        PathResult expected = findPath(fresh, open, start, goal, algorithm);
+        if (rejected.found || rejected.expanded != 0 || !result.found || result.cost != expected.cost
+            || result.path != expected.path) {
+            ++failures;
+            std::cout << name << " " << algorithmName(algorithm) << ": rejected found=" << rejected.found
+                      << " expanded=" << rejected.expanded << ", reused cost=" << result.cost
+                      << ", fresh cost=" << expected.cost << std::endl;
+        }
+    }
+    return failures;
+}
+
+int checkRejectedQueryReuse() {
+    return checkRejectedThenReused<BasicSearchContext<Manhattan, FourConnected>>("search-4")
+         + checkRejectedThenReused<BasicSearchContext<Octile, EightConnected<>>>("search-8")
+         + checkRejectedThenReused<BasicBidirectionalContext<Manhattan, FourConnected>>("bidirectional-4")
+         + checkRejectedThenReused<BasicBidirectionalContext<Octile, EightConnected<>>>("bidirectional-8");
+}
+
+// 地标必须选在最大的连通分量里：行优先的第一格是孤立角落、地图上散布着小块不连通区域时，
+// 从那里出发选地标曾得到空表，或把地标放进各个小块里，A* 的扩展数与不用地标时完全相同
+template <typename Heuristic, typename Neighborhood>
+int checkLandmarksAvoidPockets(const char *name, ComponentIndex::Connectivity connectivity) {
+    std::mt19937 random(7);
+    GridMap map(128, 128);
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    for (int y = 0; y < map.height(); ++y) {
+        for (int x = 0; x < map.width(); ++x) {
+            map.setObstacle(x, y, unit(random) < 0.3);
+        }
+    }
+    // (0, 0) 四周都是墙
+    for (GridPoint wall : { GridPoint{1, 0}, GridPoint{0, 1}, GridPoint{1, 1} }) {
+        map.setObstacle(wall.x, wall.y, true);
+    }
+    map.setObstacle(0, 0, false);
+
+    const int count = 8;
+    int failures = 0;
+    LandmarkTable table;
+    std::string error;
+    if (!table.build<Neighborhood>(map, count, &error) || table.count() != count) {
+        std::cout << name << ": built " << table.count() << " of " << count << " landmarks " << error << std::endl;
+        return 1;
+    }
+    ComponentIndex components(map, connectivity);
+    int largest = components.component(table.landmarks()[0]);
+    for (int landmark : table.landmarks()) {
+        if (components.component(landmark) != largest) {
+            ++failures;
+            std::cout << name << ": landmark " << landmark << " is outside the component of the first one" << std::endl;
+        }
+    }
+
+    BasicSearchContext<Heuristic, Neighborhood> plain;
+    BasicSearchContext<Heuristic, Neighborhood> alt;
+    alt.setLandmarks(&table);
+    long long plainExpanded = 0;
+    long long altExpanded = 0;
+    for (int queries = 0; queries < 100;) {
+        GridPoint start = randomPoint(random, map);
+        GridPoint goal = randomPoint(random, map);
+        if (components.component(map.index(start.x, start.y)) != largest || !components.connected(start, goal)) {
+            continue;
+        }
+        ++queries;
+        PathResult expected = findPath(plain, map, start, goal, Algorithm::AStar);
+        PathResult result = findPath(alt, map, start, goal, Algorithm::AStar);
+        plainExpanded += expected.expanded;
+        altExpanded += result.expanded;
+        if (!result.found || result.cost != expected.cost) {
+            ++failures;
+            std::cout << name << ": " << start << " -> " << goal << " cost " << result.cost << " with landmarks, "
+                      << expected.cost << " without" << std::endl;
+        }
+    }
+    std::cout << name << ": " << altExpanded << " nodes expanded with landmarks, " << plainExpanded << " without" << std::endl;
+    if (altExpanded * 10 > plainExpanded * 9) {
+        ++failures;
+    }
+    return failures;
+}
+
+int checkLandmarkPlacement() {
+    int failures = checkLandmarksAvoidPockets<Manhattan, FourConnected>("alt-4", ComponentIndex::Orthogonal)
+                 + checkLandmarksAvoidPockets<Octile, EightConnected<>>("alt-8", ComponentIndex::Orthogonal);
+
+    // 没有可走格时建表失败，而不是悄悄得到一张空表
+    GridMap walls(4, 4);
+    for (int index = 0; index < walls.cellCount(); ++index) {
+        walls.setObstacle(index % 4, index / 4, true);
+    }
+    LandmarkTable table;
+    if (table.build(walls, 8) || !table.isEmpty()) {
+        ++failures;
+        std::cout << "alt: building on a map without passable cells did not fail" << std::endl;
+    }
+    return failures;
+}
+
+// 在 path 的 offset 处覆盖写入 size 字节
+bool patchFile(const std::string &path, std::streamoff offset, const void *data, size_t size) {
+    std::fstream file(path, std::ios::in | std::ios::out | std::ios::binary);
+    file.seekp(offset);
+    file.write(static_cast<const char *>(data), std::streamsize(size));
+    return bool(file);
+}
+
+// 损坏的地图文件必须被拒绝：代价 0、超过文件头所记最大值的代价，以及相加会溢出的段偏移
+int checkMapFileValidation() {
+    // 与 mapfile.cpp 的文件头一致：maxCost 在第 24 字节，行位板偏移在第 32 字节，代价层偏移在第 48 字节
+    const std::streamoff maxCostField = 24;
+    const std::streamoff rowOffsetField = 32;
+    const std::streamoff costOffsetField = 48;
+    const std::string path = "astar_tests_map.gmap";
+
+    GridMap map(16, 8);
+    map.setCost(3, 2, 9);
+    map.setObstacle(5, 5, true);
+    GridMap opened;
+    std::string error;
+    if (!MapFile::save(map, path, &error) || !MapFile::open(path, opened, &error)
+        || opened.cost(3, 2) != 9 || !opened.isObstacle(5, 5)) {
+        std::cout << "map-file: round trip failed " << error << std::endl;
+        std::remove(path.c_str());
+        return 1;
+    }
+    opened = GridMap();
+
+    struct Corruption {
+        const char *what;
+        std::streamoff offset;
+        uint64_t value;
+        size_t size;
+    };
+    uint64_t costOffset = 0;
+    std::ifstream(path, std::ios::binary).seekg(costOffsetField).read(reinterpret_cast<char *>(&costOffset), sizeof(costOffset));
+    const Corruption corruptions[] = {
+        { "zero cost", std::streamoff(costOffset), 0, 1 },
+        { "cost above the header maximum", std::streamoff(costOffset), 10, 1 },
+        { "zero maximum cost", maxCostField, 0, 4 },
+        { "overflowing row offset", rowOffsetField, UINT64_MAX - 63, 8 },
+        { "overflowing cost offset", costOffsetField, UINT64_MAX - 63, 8 },
+    };
+
+    int failures = 0;
+    for (const Corruption &corruption : corruptions) {
+        if (!MapFile::save(map, path, &error) || !patchFile(path, corruption.offset, &corruption.value, corruption.size)) {
+            std::cout << "map-file: cannot prepare " << corruption.what << std::endl;
+            ++failures;
+            continue;
+        }
+        GridMap corrupt;
+        if (MapFile::open(path, corrupt, &error)) {
+            std::cout << "map-file: opened a file with " << corruption.what << std::endl;
+            ++failures;
+        }
+    }
+    std::remove(path.c_str());
+    return failures;
+}
+
+const Check kChecks[] = {
+    { "context-reuse", checkContextReuse },
+    { "rejected-query-reuse", checkRejectedQueryReuse },
+    { "landmark-placement", checkLandmarkPlacement },
+    { "map-file-validation", checkMapFileValidation },
+};
+
+}
+
+int main(int argc, char *argv[]) {
+    std::vector<const Check *> selected;
+    for (int i = 1; i < argc; ++i) {
+        const Check *found = nullptr;
+        for (const Check &check : kChecks) {
+            if (std::strcmp(check.name, argv[i]) == 0) {
+                found = &check;
+            }
+        }
+        if (!found) {
+            std::cerr << "unknown check: " << argv[i] << std::endl;
+            return 2;
+        }
+        selected.push_back(found);
+    }
+    if (selected.empty()) {
+        for (const Check &check : kChecks) {
+            selected.push_back(&check);
+        }
+    }
+
+    int failed = 0;
+    for (const Check *check : selected) {
+        int failures = check->run();
+        std::cout << check->name << ": " << (failures == 0 ? "ok" : "FAILED") << " (" << failures << " failures)" << std::endl;
+        failed += failures == 0 ? 0 : 1;
+    }
+    return failed == 0 ? 0 : 1;
+}
@@ -0,0 +1,56 @@
+#include "batchpathfinder.h"
+
+namespace {
+
+// 每次从队列里取的查询数；单个查询耗时差异很大，取小块便于窃取均衡
+const int kQueryGrain = 8;
+
+}
+
+BatchPathfinder::BatchPathfinder(int threadCount)
+    : m_pool(threadCount),
+      m_contexts(size_t(m_pool.threadCount()))
+{
+}
+
+std::vector<PathResult> BatchPathfinder::findPaths(const GridMap &map, const std::vector<PathQuery> &queries) {
+    std::vector<PathResult> results(queries.size());
+
+    // 地图散列在分发前取一次，工作线程只读它
+    PathKey mapKey;
+    if (m_cache) {
+        mapKey.mapHash = map.contentHash();
+        mapKey.width = map.width();
+        mapKey.height = map.height();
+    }
+    bool useDatabase = m_database && m_database->appliesTo<FourConnected>(map);
+
+    m_pool.parallelFor(int(queries.size()), kQueryGrain, [&](int worker, int begin, int end) {
+        SearchContext &context = m_contexts[worker];
+        context.setComponentIndex(m_components);
+        for (int i = begin; i < end; ++i) {
+            const PathQuery &query = queries[i];
+            if (useDatabase && query.algorithm != Algorithm::Greedy) {
+                results[i] = m_database->findPath<FourConnected>(map, query.start, query.goal);
+                continue;
+            }
+            if (!m_cache) {
+                results[i] = findPath(context, map, query.start, query.goal, query.algorithm);
+                continue;
+            }
+
+            PathKey key = mapKey;
+            key.start = query.start;
+            key.goal = query.goal;
+            key.algorithm = query.algorithm;
+            if (std::shared_ptr<const PathResult> cached = m_cache->find(key)) {
+                results[i] = *cached;
+                continue;
+            }
+            results[i] = findPath(context, map, query.start, query.goal, query.algorithm);
+            m_cache->insert(key, std::make_shared<const PathResult>(results[i]), memoryBytes(results[i]));
+        }
+    });
+
+    return results;
+}
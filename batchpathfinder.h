@@ -0,0 +1,47 @@
+#ifndef BATCHPATHFINDER_H
+#define BATCHPATHFINDER_H
+
+#include "pathcache.h"
+#include "pathdatabase.h"
+#include "pathengine.h"
+#include "workstealingpool.h"
+#include <vector>
+
+struct PathQuery {
+    GridPoint start;
+    GridPoint goal;
+    Algorithm algorithm = Algorithm::AStar;
+};
+
+// 批量寻路：在同一张只读地图上并行执行大量起点/终点查询。
+// 每个工作线程持有自己的 SearchContext，查询之间复用搜索内存。
+class BatchPathfinder {
+public:
+    // threadCount 为 0 时使用硬件并发数
+    explicit BatchPathfinder(int threadCount = 0);
+
+    int threadCount() const { return m_pool.threadCount(); }
+
+    // 查询前先查缓存，未命中的结果算完后放回去；nullptr 表示不用缓存。
+    // 缓存由调用方持有，可以在多个 BatchPathfinder 之间共享
+    void setCache(PathCache *cache) { m_cache = cache; }
+
+    // 连通分量索引必须由传给 findPaths 的地图构建；不连通的查询不搜索，直接返回未找到
+    void setComponentIndex(const ComponentIndex *index) { m_components = index; }
+
+    // 静态地图的压缩路径数据库（必须由传给 findPaths 的地图按四邻域构建）；
+    // 设置后 Dijkstra、A* 和跳点搜索的查询直接查表，贪心搜索仍然搜索，结果不放进缓存
+    void setPathDatabase(const PathDatabase *database) { m_database = database; }
+
+    // 结果顺序与 queries 一一对应
+    std::vector<PathResult> findPaths(const GridMap &map, const std::vector<PathQuery> &queries);
+
+private:
+    WorkStealingPool m_pool;
+    std::vector<SearchContext> m_contexts;
+    PathCache *m_cache = nullptr;
+    const ComponentIndex *m_components = nullptr;
+    const PathDatabase *m_database = nullptr;
+};
+
+#endif // BATCHPATHFINDER_H
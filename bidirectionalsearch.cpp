@@ -0,0 +1,3 @@
+#include "bidirectionalsearch.h"
+
+template class BasicBidirectionalContext<>;
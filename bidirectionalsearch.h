@@ -0,0 +1,405 @@
+#ifndef BIDIRECTIONALSEARCH_H
+#define BIDIRECTIONALSEARCH_H
+
+#include "pathengine.h"
+#include <algorithm>
+
+// 双向 Dijkstra / A*：起点向前、终点向后各一棵搜索树，两边关闭的节点相遇时记录候选路径，
+// 满足停止条件时最好的候选就是最短路径。
+//
+// A* 用平衡势（Ikeda；Goldberg–Harrelson 的平均势）：正向的势是 (h(v, 终点) - h(起点, v)) / 2，
+// 反向取相反数，两侧都等价于约化图上的 Dijkstra。停止条件（启发函数一致、代价非负）统一为
+// 一侧出队的键加上另一侧最近出队的键不小于两倍的最好候选（键见 key()，Dijkstra 的势为 0）。
+// 相遇只在一侧关闭节点时检查另一侧已关闭的节点（节点本身及其邻居）。
+//
+// 节省的扩展远不到一半，用 astar_bench 实测：1024×1024 空地图四邻域的长查询上，双向 Dijkstra
+// 扩展单向的约 80%，双向 A* 约 70% 但每秒查询数与 A* 相当；30% 随机障碍的八邻域地图上双向 A*
+// 约为 A* 的 70%、快约一倍；空地图八邻域上八角距离几乎精确，双向 A* 反而比 A* 多扩展约 40%。
+//
+// 反向搜索在反向图上进行：从 v 走到 u 的代价取 u 的通行代价，斜向规则按 v 到 u 的方向检查。
+// 只支持 Dijkstra 和 AStar，其它算法按 AStar 处理；启发权重不适用，结果总是最优。
+template <typename Heuristic = Manhattan, typename Neighborhood = FourConnected, typename OpenSet = IndexedHeap<int>>
+class BasicBidirectionalContext {
+public:
+    using Status = SearchContextBase::Status;
+
+    void begin(const GridMap &map, GridPoint start, GridPoint goal, Algorithm algorithm);
+
+    // 与 SearchContextBase::setComponentIndex 相同：起点和终点不连通时 begin() 直接结束，
+    // 不重置两侧网格（尺寸不符时才重新分配）
+    void setComponentIndex(const ComponentIndex *index) { m_components = index; }
+
+    // 扩展一个节点：选开放集合较小的一侧
+    template <typename Recorder>
+    Status step(Recorder &recorder);
+    Status step() { NullRecorder recorder; return step(recorder); }
+
+    // 交替扩展两侧，直到结束
+    Status run();
+
+    Status status() const { return m_status; }
+    Algorithm algorithm() const { return m_algorithm; }
+    int expandedCount() const { return m_sides[0].expanded + m_sides[1].expanded; }
+    // 两侧计数之和，开放集合峰值取较大的一侧；begin() 和 run() 分别计入 Setup、Search 阶段
+    SearchMetrics metrics() const;
+    int cost() const { return m_status == SearchContextBase::Found ? m_bestCost : 0; }
+
+    // 起点一侧和终点一侧各自的搜索网格；反向网格的 g 是到终点的代价，父节点指向终点方向
+    const SearchGrid &forwardGrid() const { return m_sides[0].grid; }
+    const SearchGrid &backwardGrid() const { return m_sides[1].grid; }
+
+    // 两侧合并后的单元格状态：已被起点一侧到达的格子显示起点一侧的代价，否则显示终点一侧的；
+    // 任一侧关闭即为关闭。grid() 每次调用都整体合并一遍，逐格查询请用 cellState()
+    SearchGrid::CellState cellState(int index) const;
+    const SearchGrid &grid() const;
+
+    // 起点一侧的树到相遇边，再沿终点一侧的树到终点（起点在前）；未找到时为空
+    std::vector<GridPoint> path() const;
+
+private:
+    static constexpr int Forward = 0;
+    static constexpr int Backward = 1;
+
+    struct Frontier {
+        SearchGrid grid;
+        OpenSet open;
+        int root = -1;           // 这一侧的起始格
+        int lastKey = 0;         // 最近出队的键，随扩展单调不减
+        int expanded = 0;
+        GridPoint target;        // 启发函数估计到这一点的距离
+        SearchMetrics metrics;
+
+        // 已关闭节点的 g，供另一侧检查相遇；根节点到自身的代价就是 0，不等关闭就算数，
+        // 一侧走到另一侧的根时总能记下候选。其余格子返回 Unreached
+        int settled(int index) const {
+            return grid.isClosed(index) || index == root ? grid.g[index] : SearchGrid::Unreached;
+        }
+    };
+
+    // 扩展 side 一侧的下一个节点；开放集合为空或满足停止条件时返回 false
+    template <typename Recorder>
+    bool expand(int side, Recorder &recorder);
+
+    void offer(int cost, int forwardNode, int backwardNode);
+    void finish();
+
+    // 清空一侧的网格以适配 map：尺寸相同时按写入记录清空，否则重新分配
+    static void resetSide(Frontier &side, const GridMap &map);
+
+    int heuristic(int side, int x, int y) const {
+        if (m_algorithm == Algorithm::Dijkstra) {
+            return 0;
+        }
+        const GridPoint &target = m_sides[side].target;
+        return Heuristic::template estimate<Neighborhood>(std::abs(x - target.x), std::abs(y - target.y));
+    }
+
+    // 开放集合的键：2g 加上平衡势 h(本侧目标) - h(对侧目标)，即两侧启发值之差的一半放大两倍取整。
+    // 两侧的势互为相反数，约化后的边权非负，两侧相当于在同一张约化图上做双向 Dijkstra
+    int key(int side, int g, int x, int y) const {
+        return 2 * g + heuristic(side, x, y) - heuristic(1 - side, x, y);
+    }
+
+    const GridMap *m_map = nullptr;
+    const ComponentIndex *m_components = nullptr;
+    Algorithm m_algorithm = Algorithm::AStar;
+    Frontier m_sides[2];
+
+    int m_bestCost = SearchGrid::Unreached;            // 最好候选的代价
+    int m_meetForward = -1;                            // 相遇边在起点一侧的端点
+    int m_meetBackward = -1;                           // 相遇边在终点一侧的端点（相遇在节点上时两者相同）
+
+    Status m_status = SearchContextBase::Exhausted;
+    SearchMetrics m_phases;
+    mutable SearchGrid m_view;
+};
+
+using BidirectionalSearchContext = BasicBidirectionalContext<>;
+
+template <typename Heuristic, typename Neighborhood, typename OpenSet>
+void BasicBidirectionalContext<Heuristic, Neighborhood, OpenSet>::begin(const GridMap &map, GridPoint start, GridPoint goal, Algorithm algorithm) {
+    m_phases.clear();
+    PhaseTimer timer(m_phases, SearchMetrics::Setup);
+    m_map = &map;
+    m_algorithm = algorithm == Algorithm::Dijkstra ? Algorithm::Dijkstra : Algorithm::AStar;
+    m_sides[Forward].target = goal;
+    m_sides[Backward].target = start;
+
+    bool unreachable = m_components && m_components->appliesTo<Neighborhood>()
+        && m_components->width() == map.width() && m_components->height() == map.height()
+        && !m_components->connected(start, goal);
+    if (unreachable) {
+        // 不重置搜索状态，只有尺寸不符时重新分配
+        for (Frontier &side : m_sides) {
+            if (side.grid.width() != map.width() || side.grid.height() != map.height()) {
+                resetSide(side, map);
+            }
+            side.expanded = 0;
+            side.metrics.clear();
+        }
+        m_status = SearchContextBase::Exhausted;
+        return;
+    }
+
+    int cells = map.cellCount();
+    for (Frontier &side : m_sides) {
+        resetSide(side, map);
+        side.open.reset(cells);
+        side.root = -1;
+        side.lastKey = 0;
+        side.expanded = 0;
+        side.metrics.clear();
+    }
+
+    m_bestCost = SearchGrid::Unreached;
+    m_meetForward = m_meetBackward = -1;
+    m_status = SearchContextBase::Running;
+
+    if (!map.isPassable(start.x, start.y) || !map.isPassable(goal.x, goal.y)) {
+        m_status = SearchContextBase::Exhausted;
+        return;
+    }
+
+    const GridPoint roots[2] = { start, goal };
+    for (int side = Forward; side <= Backward; ++side) {
+        Frontier &frontier = m_sides[side];
+        int root = map.index(roots[side].x, roots[side].y);
+        int h = heuristic(side, roots[side].x, roots[side].y);
+        frontier.root = root;
+        frontier.grid.touch(root);
+        frontier.grid.g[root] = 0;
+        frontier.grid.h[root] = h;
+        frontier.grid.f[root] = h;
+        frontier.grid.flags[root] = SearchGrid::Open;
+        frontier.open.push(root, key(side, 0, roots[side].x, roots[side].y));
+        frontier.metrics.push(frontier.open.size());
+    }
+
+    if (start == goal) {
+        offer(0, map.index(start.x, start.y), map.index(goal.x, goal.y));
+        finish();
+    }
+}
+
+template <typename Heuristic, typename Neighborhood, typename OpenSet>
+void BasicBidirectionalContext<Heuristic, Neighborhood, OpenSet>::resetSide(Frontier &side, const GridMap &map) {
+    if (side.grid.width() == map.width() && side.grid.height() == map.height()) {
+        side.grid.resetSearch();
+    } else {
+        side.grid = SearchGrid(map.width(), map.height());
+    }
+}
+
+template <typename Heuristic, typename Neighborhood, typename OpenSet>
+template <typename Recorder>
+typename BasicBidirectionalContext<Heuristic, Neighborhood, OpenSet>::Status BasicBidirectionalContext<Heuristic, Neighborhood, OpenSet>::step(Recorder &recorder) {
+    if (m_status != SearchContextBase::Running) {
+        return m_status;
+    }
+
+    int side = m_sides[Forward].open.size() <= m_sides[Backward].open.size() ? Forward : Backward;
+    if (!expand(side, recorder)) {
+        finish();
+    }
+    return m_status;
+}
+
+template <typename Heuristic, typename Neighborhood, typename OpenSet>
+typename BasicBidirectionalContext<Heuristic, Neighborhood, OpenSet>::Status BasicBidirectionalContext<Heuristic, Neighborhood, OpenSet>::run() {
+    PhaseTimer timer(m_phases, SearchMetrics::Search);
+    NullRecorder recorder;
+    while (step(recorder) == SearchContextBase::Running) {
+    }
+    return m_status;
+}
+
+template <typename Heuristic, typename Neighborhood, typename OpenSet>
+template <typename Recorder>
+bool BasicBidirectionalContext<Heuristic, Neighborhood, OpenSet>::expand(int side, Recorder &recorder) {
+    Frontier &self = m_sides[side];
+    const Frontier &other = m_sides[1 - side];
+    if (self.open.empty()) {
+        // 这一侧能到达的节点已全部关闭，距离都是精确值；两个根一开始就算作已关闭，有路径就一定记下了
+        return false;
+    }
+
+    int current = self.open.pop();
+    self.metrics.pop();
+    int g = self.grid.g[current];
+    int currentX = self.grid.xOf(current);
+    int currentY = self.grid.yOf(current);
+    self.lastKey = key(side, g, currentX, currentY);
+
+    // 两侧键的下界之和不小于两倍的最好候选时，约化图上已不可能有更短的路径
+    if (m_bestCost != SearchGrid::Unreached && (long long)self.lastKey + other.lastKey >= 2LL * m_bestCost) {
+        return false;
+    }
+
+    self.grid.flags[current] = SearchGrid::Closed;
+    recorder.touch(current);
+    ++self.expanded;
+    self.metrics.expand();
+
+    int otherG = other.settled(current);
+    if (otherG != SearchGrid::Unreached) {
+        offer(g + otherG, current, current);
+    }
+
+    for (const auto &offset : Neighborhood::Offsets) {
+        int nx = currentX + offset[0];
+        int ny = currentY + offset[1];
+        if (!m_map->contains(nx, ny)) {
+            continue;
+        }
+
+        int neighbor = self.grid.index(nx, ny);
+        if (m_map->isObstacle(neighbor)) {
+            continue;
+        }
+
+        // 正向从 current 走到 neighbor；反向对应原图中从 neighbor 走到 current
+        int moveCost;
+        if (side == Forward) {
+            if (!Neighborhood::canMove(*m_map, currentX, currentY, offset[0], offset[1])) {
+                continue;
+            }
+            moveCost = Neighborhood::cost(offset[0], offset[1]) * m_map->cost(neighbor);
+        } else {
+            if (!Neighborhood::canMove(*m_map, nx, ny, -offset[0], -offset[1])) {
+                continue;
+            }
+            moveCost = Neighborhood::cost(offset[0], offset[1]) * m_map->cost(current);
+        }
+        int tentativeG = g + moveCost;
+
+        otherG = other.settled(neighbor);
+        if (otherG != SearchGrid::Unreached) {
+            if (side == Forward) {
+                offer(tentativeG + otherG, current, neighbor);
+            } else {
+                offer(tentativeG + otherG, neighbor, current);
+            }
+        }
+
+        if (self.grid.isClosed(neighbor) || tentativeG >= self.grid.g[neighbor]) {
+            continue;
+        }
+
+        int h = heuristic(side, nx, ny);
+        self.grid.touch(neighbor);
+        self.grid.parent[neighbor] = current;
+        self.grid.g[neighbor] = tentativeG;
+        self.grid.h[neighbor] = h;
+        self.grid.f[neighbor] = tentativeG + h;
+        recorder.touch(neighbor);
+
+        int neighborKey = key(side, tentativeG, nx, ny);
+        if (!self.grid.isOpen(neighbor)) {
+            self.grid.flags[neighbor] |= SearchGrid::Open;
+            self.open.push(neighbor, neighborKey);
+            self.metrics.push(self.open.size());
+        } else {
+            self.open.decreaseKey(neighbor, neighborKey);
+            self.metrics.decreaseKey();
+        }
+    }
+    return true;
+}
+
+template <typename Heuristic, typename Neighborhood, typename OpenSet>
+void BasicBidirectionalContext<Heuristic, Neighborhood, OpenSet>::offer(int cost, int forwardNode, int backwardNode) {
+    if (cost < m_bestCost) {
+        m_bestCost = cost;
+        m_meetForward = forwardNode;
+        m_meetBackward = backwardNode;
+    }
+}
+
+template <typename Heuristic, typename Neighborhood, typename OpenSet>
+void BasicBidirectionalContext<Heuristic, Neighborhood, OpenSet>::finish() {
+    m_status = m_bestCost != SearchGrid::Unreached ? SearchContextBase::Found : SearchContextBase::Exhausted;
+}
+
+template <typename Heuristic, typename Neighborhood, typename OpenSet>
+SearchMetrics BasicBidirectionalContext<Heuristic, Neighborhood, OpenSet>::metrics() const {
+    SearchMetrics merged = m_phases;
+    merged.merge(m_sides[Forward].metrics);
+    merged.merge(m_sides[Backward].metrics);
+    return merged;
+}
+
+template <typename Heuristic, typename Neighborhood, typename OpenSet>
+SearchGrid::CellState BasicBidirectionalContext<Heuristic, Neighborhood, OpenSet>::cellState(int index) const {
+    const SearchGrid &forward = m_sides[Forward].grid;
+    const SearchGrid &backward = m_sides[Backward].grid;
+    SearchGrid::CellState state = forward.g[index] != SearchGrid::Unreached ? forward.cellState(index) : backward.cellState(index);
+    state.flags = forward.flags[index] | backward.flags[index];
+    if (state.flags & SearchGrid::Closed) {
+        state.flags = SearchGrid::Closed;
+    }
+    return state;
+}
+
+template <typename Heuristic, typename Neighborhood, typename OpenSet>
+const SearchGrid &BasicBidirectionalContext<Heuristic, Neighborhood, OpenSet>::grid() const {
+    const SearchGrid &forward = m_sides[Forward].grid;
+    if (m_view.width() != forward.width() || m_view.height() != forward.height()) {
+        m_view = SearchGrid(forward.width(), forward.height());
+    }
+    for (int index = 0; index < forward.cellCount(); ++index) {
+        m_view.setCellState(index, cellState(index));
+    }
+    return m_view;
+}
+
+template <typename Heuristic, typename Neighborhood, typename OpenSet>
+std::vector<GridPoint> BasicBidirectionalContext<Heuristic, Neighborhood, OpenSet>::path() const {
+    std::vector<GridPoint> result;
+    if (m_status != SearchContextBase::Found) {
+        return result;
+    }
+
+    const SearchGrid &forward = m_sides[Forward].grid;
+    const SearchGrid &backward = m_sides[Backward].grid;
+    for (int index = m_meetForward; index != SearchGrid::NoParent; index = forward.parent[index]) {
+        result.push_back({forward.xOf(index), forward.yOf(index)});
+    }
+    std::reverse(result.begin(), result.end());
+
+    int index = m_meetBackward == m_meetForward ? backward.parent[m_meetBackward] : m_meetBackward;
+    for (; index != SearchGrid::NoParent; index = backward.parent[index]) {
+        result.push_back({backward.xOf(index), backward.yOf(index)});
+    }
+    return result;
+}
+
+// 默认组合在 bidirectionalsearch.cpp 中显式实例化
+extern template class BasicBidirectionalContext<>;
+
+// 复用调用方提供的双向搜索上下文
+template <typename Heuristic, typename Neighborhood, typename OpenSet>
+PathResult findPath(BasicBidirectionalContext<Heuristic, Neighborhood, OpenSet> &context, const GridMap &map,
+                    GridPoint start, GridPoint goal, Algorithm algorithm) {
+    PathResult result;
+    SearchMetrics reconstruct;
+    context.begin(map, start, goal, algorithm);
+    if (context.run() == SearchContextBase::Found) {
+        PhaseTimer timer(reconstruct, SearchMetrics::Reconstruct);
+        result.found = true;
+        result.path = context.path();
+        result.cost = context.cost();
+    }
+    result.expanded = context.expandedCount();
+    result.metrics = context.metrics();
+    result.metrics.merge(reconstruct);
+    return result;
+}
+
+// 单次双向查询，例如 findBidirectionalPath(map, start, goal, Algorithm::Dijkstra)
+template <typename Heuristic = Manhattan, typename Neighborhood = FourConnected, typename OpenSet = IndexedHeap<int>>
+PathResult findBidirectionalPath(const GridMap &map, GridPoint start, GridPoint goal, Algorithm algorithm) {
+    BasicBidirectionalContext<Heuristic, Neighborhood, OpenSet> context;
+    return findPath(context, map, start, goal, algorithm);
+}
+
+#endif // BIDIRECTIONALSEARCH_H
@@ -0,0 +1,33 @@
+#ifndef BITSCAN_H
+#define BITSCAN_H
+
+#include <cstdint>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+// 64 位字的位扫描原语，编译成单条 tzcnt/bsf 或 lzcnt/bsr 指令。
+// 参数都不能为 0。
+
+inline int countTrailingZeros(uint64_t value) {
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward64(&index, value);
+    return int(index);
+#else
+    return __builtin_ctzll(value);
+#endif
+}
+
+inline int countLeadingZeros(uint64_t value) {
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanReverse64(&index, value);
+    return 63 - int(index);
+#else
+    return __builtin_clzll(value);
+#endif
+}
+
+#endif // BITSCAN_H
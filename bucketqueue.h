@@ -0,0 +1,154 @@
+#ifndef BUCKETQUEUE_H
+#define BUCKETQUEUE_H
+
+#include <algorithm>
+#include <vector>
+
+// 带索引的桶队列（Dial 算法）：键是非负整数，每个键值一个桶，桶内元素用双向链表串起来，
+// push 和 decreaseKey 都是 O(1)，pop 从当前最小键向后扫描第一个非空桶。
+// 桶数组是环形的，只需覆盖队列中键的跨度：边权有界时，Dijkstra 和一致启发的 A*
+// 队列里的键跨度不超过最大边权的常数倍，与地图大小无关。跨度超出桶数时自动扩容。
+// 接口与 IndexedHeap 相同，可以直接作为搜索内核的开放集合。
+class BucketQueue {
+public:
+    static constexpr int NotInQueue = -1;
+
+    BucketQueue() = default;
+    explicit BucketQueue(int capacity) { reset(capacity); }
+
+    // 清空并调整容量，之后可以放入 [0, capacity) 的任意元素。
+    // 容量不变时只清除仍在队列中的元素，代价与桶数和队列大小成正比
+    void reset(int capacity) {
+        if (m_key.size() == size_t(capacity) && !m_heads.empty()) {
+            for (int &head : m_heads) {
+                for (int item = head; item != NotInQueue; item = m_next[item]) {
+                    m_key[item] = NotInQueue;
+                }
+                head = NotInQueue;
+            }
+        } else {
+            m_key.assign(size_t(capacity), NotInQueue);
+            m_next.resize(size_t(capacity));
+            m_previous.resize(size_t(capacity));
+            if (m_heads.empty()) {
+                m_heads.assign(InitialBuckets, NotInQueue);
+            } else {
+                std::fill(m_heads.begin(), m_heads.end(), NotInQueue);
+            }
+        }
+        m_size = 0;
+        m_minKey = 0;
+        m_maxKey = 0;
+    }
+
+    bool empty() const { return m_size == 0; }
+    int size() const { return m_size; }
+    bool contains(int item) const { return m_key[item] != NotInQueue; }
+    int keyOf(int item) const { return m_key[item]; }
+
+    void push(int item, int key) {
+        m_key[item] = key;
+        if (m_size == 0) {
+            m_minKey = m_maxKey = key;
+        } else {
+            m_minKey = std::min(m_minKey, key);
+            m_maxKey = std::max(m_maxKey, key);
+        }
+        ensureSpan();
+        link(item);
+        ++m_size;
+    }
+
+    int pop() {
+        int mask = int(m_heads.size()) - 1;
+        while (m_heads[m_minKey & mask] == NotInQueue) {
+            ++m_minKey;
+        }
+        int item = m_heads[m_minKey & mask];
+        unlink(item);
+        m_key[item] = NotInQueue;
+        --m_size;
+        return item;
+    }
+
+    // 新键不得比原键更大（相等也允许）
+    void decreaseKey(int item, int key) {
+        unlink(item);
+        m_key[item] = key;
+        m_minKey = std::min(m_minKey, key);
+        ensureSpan();
+        link(item);
+    }
+
+    // 不在队列中则插入，否则降低键值
+    void pushOrDecrease(int item, int key) {
+        if (contains(item)) {
+            decreaseKey(item, key);
+        } else {
+            push(item, key);
+        }
+    }
+
+private:
+    static constexpr int InitialBuckets = 256;
+
+    // 同一个桶里的元素键值相同；新元素放在链表头，键相同时后进先出，偏向刚扩展出的节点
+    void link(int item) {
+        int bucket = m_key[item] & (int(m_heads.size()) - 1);
+        int head = m_heads[bucket];
+        m_next[item] = head;
+        m_previous[item] = NotInQueue;
+        if (head != NotInQueue) {
+            m_previous[head] = item;
+        }
+        m_heads[bucket] = item;
+    }
+
+    void unlink(int item) {
+        int next = m_next[item];
+        int previous = m_previous[item];
+        if (previous != NotInQueue) {
+            m_next[previous] = next;
+        } else {
+            m_heads[m_key[item] & (int(m_heads.size()) - 1)] = next;
+        }
+        if (next != NotInQueue) {
+            m_previous[next] = previous;
+        }
+    }
+
+    // 保证 [m_minKey, m_maxKey] 中的每个键落在不同的桶里；不够时桶数翻倍并重新挂链
+    void ensureSpan() {
+        int span = m_maxKey - m_minKey + 1;
+        if (span <= int(m_heads.size())) {
+            return;
+        }
+
+        std::vector<int> items;
+        items.reserve(size_t(m_size));
+        for (int head : m_heads) {
+            for (int item = head; item != NotInQueue; item = m_next[item]) {
+                items.push_back(item);
+            }
+        }
+
+        size_t buckets = m_heads.size();
+        while (buckets < size_t(span)) {
+            buckets *= 2;
+        }
+        m_heads.assign(buckets, NotInQueue);
+        for (int item : items) {
+            link(item);
+        }
+    }
+
+    std::vector<int> m_key;        // 每个元素的键，NotInQueue 表示不在队列中
+    std::vector<int> m_next;
+    std::vector<int> m_previous;
+    std::vector<int> m_heads;      // 环形桶数组，长度为 2 的幂，键 k 落在 k & (长度 - 1)
+    int m_size = 0;
+    int m_minKey = 0;              // 队列中最小键的下界，pop 从这里向后扫描
+    int m_maxKey = 0;              // 队列中最大键的上界
+};
+
+#endif // BUCKETQUEUE_H
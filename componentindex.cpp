@@ -0,0 +1,289 @@
+#include "componentindex.h"
+#include <algorithm>
+#include <cstdlib>
+
+namespace {
+
+// 前四个是直行方向，按斜向连通时再加上后四个
+const int kOffsets[8][2] = {
+    {-1, 0}, {0, -1}, {0, 1}, {1, 0},
+    {-1, -1}, {1, -1}, {-1, 1}, {1, 1}
+};
+
+// 围绕一格的八个格子，按顺时针排列，相邻两项总是直行相邻
+const int kRing[8][2] = {
+    {0, -1}, {1, -1}, {1, 0}, {1, 1},
+    {0, 1}, {-1, 1}, {-1, 0}, {-1, -1}
+};
+
+}
+
+void ComponentIndex::build(const GridMap &map, Connectivity connectivity) {
+    m_connectivity = connectivity;
+    m_width = map.width();
+    m_height = map.height();
+    m_componentCount = 0;
+    m_labels.assign(size_t(map.cellCount()), -1);
+    m_parents.clear();
+    m_ranks.clear();
+
+    for (int index = 0; index < map.cellCount(); ++index) {
+        if (m_labels[index] < 0 && !map.isObstacle(index)) {
+            flood(map, index, newLabel());
+            ++m_componentCount;
+        }
+    }
+}
+
+void ComponentIndex::update(const GridMap &map, int x, int y) {
+    // 尺寸变了，或者累计的废弃标签太多时整体重建
+    if (map.width() != m_width || map.height() != m_height
+        || m_parents.size() > size_t(map.cellCount()) * 2 + 64) {
+        build(map);
+        return;
+    }
+
+    int index = map.index(x, y);
+    if (!map.isObstacle(index)) {
+        if (m_labels[index] >= 0) {
+            return;
+        }
+        // 新的可走格自成一个分量，再与每个相邻分量合并
+        int label = newLabel();
+        m_labels[index] = label;
+        ++m_componentCount;
+        for (int i = 0; i < offsetCount(); ++i) {
+            int nx = x + kOffsets[i][0];
+            int ny = y + kOffsets[i][1];
+            if (map.isPassable(nx, ny) && unite(label, m_labels[map.index(nx, ny)])) {
+                --m_componentCount;
+            }
+        }
+        return;
+    }
+
+    int label = m_labels[index];
+    if (label < 0) {
+        return;
+    }
+    m_labels[index] = -1;
+
+    bool hasNeighbor = false;
+    for (int i = 0; i < offsetCount() && !hasNeighbor; ++i) {
+        hasNeighbor = map.isPassable(x + kOffsets[i][0], y + kOffsets[i][1]);
+    }
+    if (!hasNeighbor) {
+        --m_componentCount;
+        return;
+    }
+    if (!mightSplit(map, x, y)) {
+        return;
+    }
+
+    split(map, x, y, find(label));
+}
+
+bool ComponentIndex::connected(GridPoint a, GridPoint b) const {
+    if (a.x < 0 || a.x >= m_width || a.y < 0 || a.y >= m_height
+        || b.x < 0 || b.x >= m_width || b.y < 0 || b.y >= m_height) {
+        return false;
+    }
+    int labelA = m_labels[a.y * m_width + a.x];
+    int labelB = m_labels[b.y * m_width + b.x];
+    return labelA >= 0 && labelB >= 0 && find(labelA) == find(labelB);
+}
+
+int ComponentIndex::newLabel() {
+    int label = int(m_parents.size());
+    m_parents.push_back(label);
+    m_ranks.push_back(0);
+    return label;
+}
+
+int ComponentIndex::find(int label) const {
+    // 查询不压缩路径，保持只读；按秩合并保证树高不超过 log(标签数)，合并时再压缩
+    while (m_parents[label] != label) {
+        label = m_parents[label];
+    }
+    return label;
+}
+
+bool ComponentIndex::unite(int a, int b) {
+    int rootA = find(a);
+    int rootB = find(b);
+    for (int label : { a, b }) {
+        int root = label == a ? rootA : rootB;
+        while (m_parents[label] != root) {
+            int next = m_parents[label];
+            m_parents[label] = root;
+            label = next;
+        }
+    }
+    if (rootA == rootB) {
+        return false;
+    }
+
+    if (m_ranks[rootA] < m_ranks[rootB]) {
+        std::swap(rootA, rootB);
+    }
+    m_parents[rootB] = rootA;
+    if (m_ranks[rootA] == m_ranks[rootB]) {
+        ++m_ranks[rootA];
+    }
+    return true;
+}
+
+void ComponentIndex::flood(const GridMap &map, int seed, int label) {
+    m_labels[seed] = label;
+    m_stack.clear();
+    m_stack.push_back(seed);
+    while (!m_stack.empty()) {
+        int current = m_stack.back();
+        m_stack.pop_back();
+        int x = current % m_width;
+        int y = current / m_width;
+        for (int i = 0; i < offsetCount(); ++i) {
+            int nx = x + kOffsets[i][0];
+            int ny = y + kOffsets[i][1];
+            if (!map.isPassable(nx, ny)) {
+                continue;
+            }
+            int neighbor = map.index(nx, ny);
+            if (m_labels[neighbor] < 0) {
+                m_labels[neighbor] = label;
+                m_stack.push_back(neighbor);
+            }
+        }
+    }
+}
+
+void ComponentIndex::split(const GridMap &map, int x, int y, int oldRoot) {
+    // 从每个相邻可走格各开一路广度优先搜索，轮流各扩展一格，给走到的格子打上这一路的新标签。
+    // 两路相遇说明它们仍然连通，合并成一组；只剩一组还在扩展时停下：
+    // 已经走完的组各自是新的分量，还没走到的格子都属于剩下那一组，把那一组并回原来的分量。
+    // 这样代价取决于断开的小块，而不是整个原分量
+    int firstLabel = int(m_parents.size());
+    int searchCount = 0;
+    int labels[8];
+    size_t heads[8];
+    for (int i = 0; i < offsetCount(); ++i) {
+        int nx = x + kOffsets[i][0];
+        int ny = y + kOffsets[i][1];
+        if (!map.isPassable(nx, ny)) {
+            continue;
+        }
+        int neighbor = map.index(nx, ny);
+        int neighborLabel = m_labels[neighbor];
+        if (neighborLabel >= firstLabel) {
+            // 已被前面某一路的起点占用（斜向连通时相邻格之间也可能相邻），之后相遇时自然合并
+            continue;
+        }
+        int label = newLabel();
+        m_labels[neighbor] = label;
+        labels[searchCount] = label;
+        heads[searchCount] = 0;
+        m_queues[searchCount].assign(1, neighbor);
+        ++searchCount;
+    }
+
+    for (;;) {
+        // 还在扩展的组
+        int activeGroups[8];
+        int activeCount = 0;
+        for (int s = 0; s < searchCount; ++s) {
+            if (heads[s] == m_queues[s].size()) {
+                continue;
+            }
+            int group = find(labels[s]);
+            if (std::find(activeGroups, activeGroups + activeCount, group) == activeGroups + activeCount) {
+                activeGroups[activeCount++] = group;
+            }
+        }
+        if (activeCount <= 1) {
+            if (activeCount == 1) {
+                unite(activeGroups[0], oldRoot);
+            }
+            break;
+        }
+
+        for (int s = 0; s < searchCount; ++s) {
+            if (heads[s] == m_queues[s].size()) {
+                continue;
+            }
+            int current = m_queues[s][heads[s]++];
+            int cx = current % m_width;
+            int cy = current / m_width;
+            for (int i = 0; i < offsetCount(); ++i) {
+                int nx = cx + kOffsets[i][0];
+                int ny = cy + kOffsets[i][1];
+                if (!map.isPassable(nx, ny)) {
+                    continue;
+                }
+                int neighbor = map.index(nx, ny);
+                int neighborLabel = m_labels[neighbor];
+                if (neighborLabel >= firstLabel) {
+                    unite(labels[s], neighborLabel);
+                } else if (find(neighborLabel) == oldRoot) {
+                    m_labels[neighbor] = labels[s];
+                    m_queues[s].push_back(neighbor);
+                }
+            }
+        }
+    }
+
+    // 原分量先减去，再加上分出来的组数（包括并回原分量的那一组）
+    int groups[8];
+    int groupCount = 0;
+    for (int s = 0; s < searchCount; ++s) {
+        int group = find(labels[s]);
+        if (std::find(groups, groups + groupCount, group) == groups + groupCount) {
+            groups[groupCount++] = group;
+        }
+    }
+    m_componentCount += groupCount - 1;
+}
+
+bool ComponentIndex::mightSplit(const GridMap &map, int x, int y) const {
+    // 周围一圈的可走格之间（不经过中心）按同样的连通方式分组；
+    // 与中心相邻的可走格都落在同一组里时，经过中心的任何通路都能绕开它
+    bool passable[8];
+    int group[8];
+    for (int i = 0; i < 8; ++i) {
+        passable[i] = map.isPassable(x + kRing[i][0], y + kRing[i][1]);
+        group[i] = i;
+    }
+
+    // 八个格子，重复松弛到不再变化即可
+    for (bool changed = true; changed;) {
+        changed = false;
+        for (int i = 0; i < 8; ++i) {
+            for (int j = i + 1; j < 8; ++j) {
+                if (!passable[i] || !passable[j] || group[i] == group[j]) {
+                    continue;
+                }
+                int dx = std::abs(kRing[i][0] - kRing[j][0]);
+                int dy = std::abs(kRing[i][1] - kRing[j][1]);
+                bool adjacent = m_connectivity == Diagonal ? dx <= 1 && dy <= 1 : dx + dy == 1;
+                if (adjacent) {
+                    group[i] = group[j] = std::min(group[i], group[j]);
+                    changed = true;
+                }
+            }
+        }
+    }
+
+    int firstGroup = -1;
+    for (int i = 0; i < 8; ++i) {
+        // 直行连通时只有上下左右四格与中心相邻，它们在圈中的位置是偶数
+        bool touchesCenter = m_connectivity == Diagonal || i % 2 == 0;
+        if (!passable[i] || !touchesCenter) {
+            continue;
+        }
+        if (firstGroup < 0) {
+            firstGroup = group[i];
+        } else if (group[i] != firstGroup) {
+            return true;
+        }
+    }
+    return false;
+}
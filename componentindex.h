@@ -0,0 +1,73 @@
+#ifndef COMPONENTINDEX_H
+#define COMPONENTINDEX_H
+
+#include "gridmap.h"
+#include <vector>
+
+// 可走格子的连通分量索引：起点和终点不在同一个分量时不必搜索，直接判定无路径。
+//
+// 每格存一个标签，标签之间用并查集合并：
+// - 拆掉障碍物时给这一格一个新标签，与相邻可走格的标签合并，几乎是常数时间；
+// - 放置障碍物时先看这一格周围一圈：相邻的可走格不经过它也彼此连通时分量不变，
+//   否则从各相邻格同时洪泛，只有一路还在扩展时停下，代价与断开的较小部分成正比。
+// 查询只读，可以被多个搜索同时使用；修改必须与查询错开。
+class ComponentIndex {
+public:
+    // 连通方式要与搜索的邻域一致：四邻域和不允许切角的八邻域按直行连通，
+    // 只有 CornerRule::CutCorners 的斜向移动能连通两个没有直行通路的格子
+    enum Connectivity {
+        Orthogonal,
+        Diagonal
+    };
+
+    ComponentIndex() = default;
+    explicit ComponentIndex(const GridMap &map, Connectivity connectivity = Orthogonal) { build(map, connectivity); }
+
+    // 扫描整张地图重新编号；不给连通方式时沿用当前的
+    void build(const GridMap &map, Connectivity connectivity);
+    void build(const GridMap &map) { build(map, m_connectivity); }
+
+    // (x, y) 的障碍物状态已经在 map 中改变后调用；map 尺寸与索引不一致时整体重建
+    void update(const GridMap &map, int x, int y);
+
+    Connectivity connectivity() const { return m_connectivity; }
+    int width() const { return m_width; }
+    int height() const { return m_height; }
+    int componentCount() const { return m_componentCount; }
+
+    // 所在分量的编号，障碍物返回 -1；编号只在两次修改之间有意义
+    int component(int index) const { return m_labels[index] < 0 ? -1 : find(m_labels[index]); }
+
+    // 两点都可走且在同一个分量里；越界返回 false
+    bool connected(GridPoint a, GridPoint b) const;
+
+    // 按这个索引拒绝查询对该邻域是否安全：按直行编号的索引比斜向连通的邻域分得更细，不能使用
+    template <typename Neighborhood>
+    bool appliesTo() const { return m_connectivity == Diagonal || !Neighborhood::ConnectsDiagonally; }
+
+private:
+    int newLabel();
+    int find(int label) const;
+    // 合并两个标签所在的集合；原本已在同一集合时返回 false
+    bool unite(int a, int b);
+
+    // 从 seed 开始给所有尚未编号的可走格打上 label
+    void flood(const GridMap &map, int seed, int label);
+    // (x, y) 刚变成障碍，它原来所在的分量（根为 oldRoot）按需拆开
+    void split(const GridMap &map, int x, int y, int oldRoot);
+    // 把 (x, y) 变成障碍后，相邻的可走格是否可能不再连通
+    bool mightSplit(const GridMap &map, int x, int y) const;
+    int offsetCount() const { return m_connectivity == Diagonal ? 8 : 4; }
+
+    Connectivity m_connectivity = Orthogonal;
+    int m_width = 0;
+    int m_height = 0;
+    int m_componentCount = 0;
+    std::vector<int> m_labels;    // 每格的标签，障碍物为 -1
+    std::vector<int> m_parents;   // 标签的并查集，根的父节点是自身
+    std::vector<uint8_t> m_ranks;
+    std::vector<int> m_stack;     // 洪泛用的栈，跨调用复用
+    std::vector<int> m_queues[8]; // 拆分时每个相邻格一路的队列
+};
+
+#endif // COMPONENTINDEX_H
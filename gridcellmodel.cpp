@@ -0,0 +1,91 @@
+#include "gridcellmodel.h"
+#include <algorithm>
+
+GridCellModel::GridCellModel(QObject *parent)
+    : QAbstractListModel(parent)
+{
+}
+
+int GridCellModel::rowCount(const QModelIndex &parent) const {
+    return parent.isValid() ? 0 : m_cells.size();
+}
+
+QVariant GridCellModel::data(const QModelIndex &index, int role) const {
+    if (!index.isValid() || index.row() >= m_cells.size()) {
+        return QVariant();
+    }
+
+    const Cell &cell = m_cells[index.row()];
+    switch (role) {
+    case CellXRole: return index.row() % m_gridSize;
+    case CellYRole: return index.row() / m_gridSize;
+    case CellFlagsRole: return int(cell.flags);
+    case GRole: return int(cell.g);
+    case HRole: return int(cell.h);
+    case FRole: return int(cell.f);
+    }
+    return QVariant();
+}
+
+QHash<int, QByteArray> GridCellModel::roleNames() const {
+    return {
+        { CellXRole, "cellX" },
+        { CellYRole, "cellY" },
+        { CellFlagsRole, "cellFlags" },
+        { GRole, "g" },
+        { HRole, "h" },
+        { FRole, "f" }
+    };
+}
+
+void GridCellModel::setCells(int gridSize, const QVector<Cell> &cells) {
+    if (gridSize != m_gridSize || cells.size() != m_cells.size()) {
+        beginResetModel();
+        m_gridSize = gridSize;
+        m_cells = cells;
+        endResetModel();
+        return;
+    }
+
+    QVector<int> changed;
+    for (int i = 0; i < cells.size(); ++i) {
+        if (m_cells[i] != cells[i]) {
+            m_cells[i] = cells[i];
+            changed.append(i);
+        }
+    }
+    emitChanged(changed);
+}
+
+void GridCellModel::updateCells(const QVector<int> &indices, const QVector<Cell> &cells) {
+    QVector<int> changed;
+    for (int i = 0; i < indices.size(); ++i) {
+        Cell &current = m_cells[indices[i]];
+        if (current != cells[i]) {
+            current = cells[i];
+            changed.append(indices[i]);
+        }
+    }
+    emitChanged(changed);
+}
+
+void GridCellModel::emitChanged(QVector<int> &changed) {
+    if (changed.isEmpty()) {
+        return;
+    }
+
+    static const QList<int> roles = { CellFlagsRole, GRole, HRole, FRole };
+    std::sort(changed.begin(), changed.end());
+    int first = changed[0];
+    int last = first;
+    for (int i = 1; i <= changed.size(); ++i) {
+        if (i < changed.size() && changed[i] <= last + 1) {
+            last = changed[i];
+            continue;
+        }
+        emit dataChanged(index(first), index(last), roles);
+        if (i < changed.size()) {
+            first = last = changed[i];
+        }
+    }
+}
@@ -0,0 +1,59 @@
+#ifndef GRIDCELLMODEL_H
+#define GRIDCELLMODEL_H
+
+#include <QAbstractListModel>
+#include <QVector>
+
+// 某个算法当前步骤的单元格列表，按行优先顺序排列，供 QML Repeater 使用。
+// 内容由 Pathfinder 按步骤历史推送；只有真正变化的单元格会发出 dataChanged，
+// 前进或后退一步时只刷新这一步触碰过的几个代理项。
+class GridCellModel : public QAbstractListModel {
+    Q_OBJECT
+
+public:
+    enum Role {
+        CellXRole = Qt::UserRole + 1,
+        CellYRole,
+        CellFlagsRole,   // Pathfinder::CellFlag 的组合
+        GRole,
+        HRole,
+        FRole
+    };
+
+    // 与 Pathfinder::cellSnapshot 的每格布局相同；未到达的代价为 0xFFFF
+    struct Cell {
+        quint16 flags = 0;
+        quint16 g = 0xFFFF;
+        quint16 h = 0;
+        quint16 f = 0xFFFF;
+
+        bool operator==(const Cell &other) const {
+            return flags == other.flags && g == other.g && h == other.h && f == other.f;
+        }
+        bool operator!=(const Cell &other) const { return !(*this == other); }
+    };
+
+    explicit GridCellModel(QObject *parent = nullptr);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QHash<int, QByteArray> roleNames() const override;
+
+    int gridSize() const { return m_gridSize; }
+    const Cell &cell(int index) const { return m_cells[index]; }
+
+    // 整体替换：尺寸变化时重置模型，否则逐格比较，只为变化的单元格发出 dataChanged
+    void setCells(int gridSize, const QVector<Cell> &cells);
+
+    // 只更新给定的单元格，indices 与 cells 一一对应，允许重复
+    void updateCells(const QVector<int> &indices, const QVector<Cell> &cells);
+
+private:
+    // 把变化的索引合并成连续区段后再发信号
+    void emitChanged(QVector<int> &changed);
+
+    int m_gridSize = 0;
+    QVector<Cell> m_cells;
+};
+
+#endif // GRIDCELLMODEL_H
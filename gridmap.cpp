@@ -0,0 +1,325 @@
+#include "gridmap.h"
+#include "bitscan.h"
+#include <algorithm>
+
+namespace {
+
+const uint64_t kAllBits = ~uint64_t(0);
+
+// splitmix64 的终结函数：把格子索引（和代价）打散成均匀的 64 位键
+uint64_t mix(uint64_t value) {
+    value += 0x9E3779B97F4A7C15ull;
+    value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ull;
+    value = (value ^ (value >> 27)) * 0x94D049BB133111EBull;
+    return value ^ (value >> 31);
+}
+
+uint64_t obstacleKey(int index) {
+    return mix(uint64_t(index) << 1);
+}
+
+// 代价为 1 的格子不参与散列，没有代价层的地图和全为 1 的代价层散列相同
+uint64_t costKey(int index, int cost) {
+    return cost == 1 ? 0 : mix((uint64_t(index) << 9 | uint64_t(cost) << 1) | 1);
+}
+
+}
+
+// 多留一个字，任意位置都能直接读出跨字边界的 64 位
+size_t GridMap::bitWordCount(int width, int height) {
+    return (size_t(width) * height + 63) / 64 + 1;
+}
+
+GridMap::GridMap(int width, int height)
+    : m_width(width),
+      m_height(height),
+      m_bits(bitWordCount(width, height), 0),
+      m_columns(bitWordCount(width, height), 0)
+{
+    attachOwned();
+}
+
+GridMap::GridMap(const GridMap &other)
+    : m_width(other.m_width),
+      m_height(other.m_height),
+      m_bits(other.m_bits),
+      m_columns(other.m_columns),
+      m_costs(other.m_costs),
+      m_maxCost(other.m_maxCost),
+      m_rowData(other.m_rowData),
+      m_columnData(other.m_columnData),
+      m_costData(other.m_costData),
+      m_owner(other.m_owner),
+      m_obstacleHash(other.m_obstacleHash),
+      m_costHash(other.m_costHash),
+      m_hashValid(other.m_hashValid)
+{
+    if (!m_owner) {
+        attachOwned();
+    }
+}
+
+GridMap::GridMap(GridMap &&other) noexcept
+    : m_width(other.m_width),
+      m_height(other.m_height),
+      m_bits(std::move(other.m_bits)),
+      m_columns(std::move(other.m_columns)),
+      m_costs(std::move(other.m_costs)),
+      m_maxCost(other.m_maxCost),
+      m_rowData(other.m_rowData),
+      m_columnData(other.m_columnData),
+      m_costData(other.m_costData),
+      m_owner(std::move(other.m_owner)),
+      m_obstacleHash(other.m_obstacleHash),
+      m_costHash(other.m_costHash),
+      m_hashValid(other.m_hashValid)
+{
+    if (!m_owner) {
+        attachOwned();
+    }
+    other = GridMap();
+}
+
+GridMap &GridMap::operator=(const GridMap &other) {
+    if (this != &other) {
+        GridMap copy(other);
+        *this = std::move(copy);
+    }
+    return *this;
+}
+
+GridMap &GridMap::operator=(GridMap &&other) noexcept {
+    if (this != &other) {
+        m_width = other.m_width;
+        m_height = other.m_height;
+        m_bits = std::move(other.m_bits);
+        m_columns = std::move(other.m_columns);
+        m_costs = std::move(other.m_costs);
+        m_maxCost = other.m_maxCost;
+        m_rowData = other.m_rowData;
+        m_columnData = other.m_columnData;
+        m_costData = other.m_costData;
+        m_owner = std::move(other.m_owner);
+        m_obstacleHash = other.m_obstacleHash;
+        m_costHash = other.m_costHash;
+        m_hashValid = other.m_hashValid;
+        if (!m_owner) {
+            attachOwned();
+        }
+
+        other.m_width = other.m_height = 0;
+        other.m_maxCost = 1;
+        other.m_rowData = other.m_columnData = nullptr;
+        other.m_costData = nullptr;
+        other.m_obstacleHash = other.m_costHash = 0;
+        other.m_hashValid = true;
+    }
+    return *this;
+}
+
+GridMap GridMap::fromExternal(int width, int height, const uint64_t *rows, const uint64_t *columns,
+                              const uint8_t *costs, int maxCost, std::shared_ptr<const void> owner) {
+    GridMap map;
+    map.m_width = width;
+    map.m_height = height;
+    map.m_maxCost = costs ? std::min(std::max(maxCost, 1), int(MaxCellCost)) : 1;
+    map.m_rowData = rows;
+    map.m_columnData = columns;
+    map.m_costData = costs;
+    map.m_owner = std::move(owner);
+    map.m_hashValid = false;
+    return map;
+}
+
+void GridMap::attachOwned() {
+    m_rowData = m_bits.empty() ? nullptr : m_bits.data();
+    m_columnData = m_columns.empty() ? nullptr : m_columns.data();
+    m_costData = m_costs.empty() ? nullptr : m_costs.data();
+}
+
+void GridMap::detach() {
+    if (!m_owner) {
+        return;
+    }
+
+    size_t words = bitWordCount(m_width, m_height);
+    m_bits.assign(m_rowData, m_rowData + words);
+    m_columns.assign(m_columnData, m_columnData + words);
+    if (m_costData) {
+        m_costs.assign(m_costData, m_costData + cellCount());
+    } else {
+        m_costs.clear();
+    }
+    m_owner.reset();
+    attachOwned();
+}
+
+uint64_t GridMap::contentHash() const {
+    if (!m_hashValid) {
+        computeHash();
+    }
+    return mix(m_obstacleHash ^ m_costHash ^ (uint64_t(uint32_t(m_width)) << 32 | uint32_t(m_height)));
+}
+
+void GridMap::computeHash() const {
+    m_obstacleHash = 0;
+    m_costHash = 0;
+    size_t words = size_t(cellCount() + 63) / 64;
+    for (size_t w = 0; w < words; ++w) {
+        for (uint64_t bits = m_rowData[w]; bits; bits &= bits - 1) {
+            int index = int(w * 64) + countTrailingZeros(bits);
+            if (index < cellCount()) {
+                m_obstacleHash ^= obstacleKey(index);
+            }
+        }
+    }
+    if (m_costData) {
+        for (int i = 0; i < cellCount(); ++i) {
+            m_costHash ^= costKey(i, m_costData[i]);
+        }
+    }
+    m_hashValid = true;
+}
+
+void GridMap::setObstacle(int x, int y, bool obstacle) {
+    detach();
+    int i = index(x, y);
+    if (m_hashValid && isObstacle(i) != obstacle) {
+        m_obstacleHash ^= obstacleKey(i);
+    }
+    int c = x * m_height + y;
+    uint64_t bit = uint64_t(1) << (i & 63);
+    uint64_t columnBit = uint64_t(1) << (c & 63);
+    if (obstacle) {
+        m_bits[i >> 6] |= bit;
+        m_columns[c >> 6] |= columnBit;
+    } else {
+        m_bits[i >> 6] &= ~bit;
+        m_columns[c >> 6] &= ~columnBit;
+    }
+}
+
+void GridMap::clearObstacles() {
+    detach();
+    m_obstacleHash = 0;
+    std::fill(m_bits.begin(), m_bits.end(), 0);
+    std::fill(m_columns.begin(), m_columns.end(), 0);
+}
+
+void GridMap::setCost(int x, int y, int cost) {
+    cost = std::min(std::max(cost, 1), MaxCellCost);
+    if (!m_costData && cost == 1) {
+        return;
+    }
+    detach();
+    if (m_costs.empty()) {
+        m_costs.assign(size_t(cellCount()), 1);
+        m_costData = m_costs.data();
+    }
+    int i = index(x, y);
+    if (m_hashValid) {
+        m_costHash ^= costKey(i, m_costs[i]) ^ costKey(i, cost);
+    }
+    m_costs[i] = uint8_t(cost);
+    m_maxCost = std::max(m_maxCost, cost);
+}
+
+void GridMap::clearCosts() {
+    detach();
+    m_costData = nullptr;
+    m_costs.clear();
+    m_costs.shrink_to_fit();
+    m_maxCost = 1;
+    m_costHash = 0;
+}
+
+uint64_t GridMap::rowBits(int x, int y) const {
+    if (y < 0 || y >= m_height) {
+        return kAllBits;
+    }
+    return windowBits(m_rowData, size_t(y) * m_width, m_width, x);
+}
+
+uint64_t GridMap::columnBits(int x, int y) const {
+    if (x < 0 || x >= m_width) {
+        return kAllBits;
+    }
+    return windowBits(m_columnData, size_t(x) * m_height, m_height, y);
+}
+
+int GridMap::freeRunInRow(int x, int y, int dx) const {
+    if (y < 0 || y >= m_height) {
+        return 0;
+    }
+    return freeRun(m_rowData, size_t(y) * m_width, m_width, x, dx);
+}
+
+int GridMap::freeRunInColumn(int x, int y, int dy) const {
+    if (x < 0 || x >= m_width) {
+        return 0;
+    }
+    return freeRun(m_columnData, size_t(x) * m_height, m_height, y, dy);
+}
+
+bool GridMap::isStraightLineClear(GridPoint a, GridPoint b) const {
+    if (!isPassable(a.x, a.y) || !isPassable(b.x, b.y)) {
+        return false;
+    }
+    if (a.y == b.y) {
+        int step = b.x >= a.x ? 1 : -1;
+        return freeRunInRow(a.x, a.y, step) >= (b.x - a.x) * step;
+    }
+    if (a.x == b.x) {
+        int step = b.y >= a.y ? 1 : -1;
+        return freeRunInColumn(a.x, a.y, step) >= (b.y - a.y) * step;
+    }
+    return false;
+}
+
+uint64_t GridMap::loadBits(const uint64_t *bits, size_t position) {
+    size_t word = position >> 6;
+    int shift = int(position & 63);
+    uint64_t value = bits[word] >> shift;
+    if (shift != 0) {
+        value |= bits[word + 1] << (64 - shift);
+    }
+    return value;
+}
+
+uint64_t GridMap::windowBits(const uint64_t *bits, size_t lineStart, int length, int offset) {
+    if (offset >= length || offset <= -64) {
+        return kAllBits;
+    }
+
+    // 窗口左侧越界的部分补 1，再把线内的位移进来
+    int lead = offset < 0 ? -offset : 0;
+    uint64_t value = lead > 0 ? (loadBits(bits, lineStart) << lead) | ((uint64_t(1) << lead) - 1)
+                              : loadBits(bits, lineStart + size_t(offset));
+
+    // 窗口右侧越界的部分补 1（也屏蔽掉下一行/列的位）
+    int inside = length - offset;
+    if (inside < 64) {
+        value |= kAllBits << inside;
+    }
+    return value;
+}
+
+int GridMap::freeRun(const uint64_t *bits, size_t lineStart, int length, int offset, int step) {
+    if (step > 0) {
+        // 第 0 位是出发格本身，从第 1 位开始找第一个障碍；每个窗口前进 63 格
+        for (int base = offset;; base += 63) {
+            uint64_t blocked = windowBits(bits, lineStart, length, base) & ~uint64_t(1);
+            if (blocked) {
+                return base + countTrailingZeros(blocked) - 1 - offset;
+            }
+        }
+    }
+
+    // 反方向：窗口的最高位是出发格，从高位往低位找第一个障碍
+    for (int end = offset;; end -= 63) {
+        uint64_t blocked = windowBits(bits, lineStart, length, end - 63) & ~(uint64_t(1) << 63);
+        if (blocked) {
+            return offset - (end - countLeadingZeros(blocked)) - 1;
+        }
+    }
+}
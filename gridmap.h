@@ -0,0 +1,120 @@
+#ifndef GRIDMAP_H
+#define GRIDMAP_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+struct GridPoint {
+    int x = 0;
+    int y = 0;
+};
+
+inline bool operator==(const GridPoint &a, const GridPoint &b) { return a.x == b.x && a.y == b.y; }
+inline bool operator!=(const GridPoint &a, const GridPoint &b) { return !(a == b); }
+
+// 只读的障碍物地图：障碍物同时打包成按行优先和按列优先的两份位集（行位板/列位板），
+// 沿行或沿列的直线扫描一次处理 64 格。可选的通行代价层为每格存一个字节。
+// 搜索过程只读取它，可以被多个搜索同时共享。
+// 三份数据可以放在自己的数组里，也可以直接引用外部内存（例如内存映射的地图文件，见 mapfile.h）；
+// 引用外部内存时复制地图不复制数据，第一次修改时才拷贝成自己的数组。
+class GridMap {
+public:
+    GridMap() = default;
+    GridMap(int width, int height);
+
+    GridMap(const GridMap &other);
+    GridMap(GridMap &&other) noexcept;
+    GridMap &operator=(const GridMap &other);
+    GridMap &operator=(GridMap &&other) noexcept;
+
+    // 每份位板的字数（含末尾多留的一个字），外部数据必须按这个长度布局
+    static size_t bitWordCount(int width, int height);
+
+    // 直接引用外部数据，不复制。rows / columns 各 bitWordCount 个字，costs 为 nullptr 表示统一代价；
+    // owner 在地图（及其所有副本）存活期间保持数据有效
+    static GridMap fromExternal(int width, int height, const uint64_t *rows, const uint64_t *columns,
+                                const uint8_t *costs, int maxCost, std::shared_ptr<const void> owner);
+    bool isExternal() const { return m_owner != nullptr; }
+
+    int width() const { return m_width; }
+    int height() const { return m_height; }
+    int cellCount() const { return m_width * m_height; }
+
+    bool contains(int x, int y) const { return x >= 0 && x < m_width && y >= 0 && y < m_height; }
+    int index(int x, int y) const { return y * m_width + x; }
+
+    bool isObstacle(int index) const { return (m_rowData[index >> 6] >> (index & 63)) & 1u; }
+    bool isObstacle(int x, int y) const { return isObstacle(index(x, y)); }
+    bool isPassable(int x, int y) const { return contains(x, y) && !isObstacle(x, y); }
+
+    void setObstacle(int x, int y, bool obstacle);
+    void clearObstacles();
+
+    // 通行代价层：进入某格的代价是移动代价乘以该格的代价，取值 [1, MaxCellCost]。
+    // 从未设置过代价的地图不分配这一层，所有格子代价为 1
+    static constexpr int MaxCellCost = 255;
+    bool hasCosts() const { return m_costData != nullptr; }
+    int cost(int index) const { return m_costData ? m_costData[index] : 1; }
+    int cost(int x, int y) const { return cost(index(x, y)); }
+    // 所有格子代价的上界，供桶队列等依赖代价范围的结构使用
+    int maxCost() const { return m_maxCost; }
+
+    // 超出范围的代价会被截断到 [1, MaxCellCost]
+    void setCost(int x, int y, int cost);
+    void clearCosts();
+
+    // 地图内容（尺寸、障碍物、代价层）的 64 位散列，可作为缓存键的一部分。
+    // 每格的障碍物和代价各对应一个随机键，按 Zobrist 方式异或在一起，setObstacle / setCost 时 O(1) 更新；
+    // 引用外部数据的地图在第一次调用时扫描一遍，这次调用不能与其他线程并发
+    uint64_t contentHash() const;
+
+    // 原始数据，供保存地图文件使用
+    const uint64_t *rowWords() const { return m_rowData; }
+    const uint64_t *columnWords() const { return m_columnData; }
+    const uint8_t *costBytes() const { return m_costData; }
+
+    // 第 y 行从 x 开始的 64 格（第 i 位对应 x + i），越界的格子视为障碍
+    uint64_t rowBits(int x, int y) const;
+    // 第 x 列从 y 开始的 64 格（第 i 位对应 y + i），越界的格子视为障碍
+    uint64_t columnBits(int x, int y) const;
+
+    // 从 (x, y) 沿 dx / dy 方向（不含自身）连续可走的格数
+    int freeRunInRow(int x, int y, int dx) const;
+    int freeRunInColumn(int x, int y, int dy) const;
+
+    // 同一行或同一列上的两点之间是否畅通（含两端）；不在同一直线上返回 false
+    bool isStraightLineClear(GridPoint a, GridPoint b) const;
+
+private:
+    // 一条线（一行或一列）在位集中从 lineStart 开始连续存放 length 格
+    static uint64_t loadBits(const uint64_t *bits, size_t position);
+    static uint64_t windowBits(const uint64_t *bits, size_t lineStart, int length, int offset);
+    static int freeRun(const uint64_t *bits, size_t lineStart, int length, int offset, int step);
+
+    // 让读取指针指向自己的数组；引用外部数据时先整体拷贝过来，然后释放外部数据
+    void attachOwned();
+    void detach();
+    void computeHash() const;
+
+    int m_width = 0;
+    int m_height = 0;
+    std::vector<uint64_t> m_bits;      // 行位板：index = y * width + x
+    std::vector<uint64_t> m_columns;   // 列位板：index = x * height + y
+    std::vector<uint8_t> m_costs;      // 代价层，为空表示统一代价 1
+    int m_maxCost = 1;
+
+    // 查询只经过这三个指针，指向上面的数组或外部数据
+    const uint64_t *m_rowData = nullptr;
+    const uint64_t *m_columnData = nullptr;
+    const uint8_t *m_costData = nullptr;
+    std::shared_ptr<const void> m_owner;   // 外部数据的所有者，为空表示数据在自己的数组里
+
+    // 障碍物部分和代价部分分开保存，清空其中一层时直接置零
+    mutable uint64_t m_obstacleHash = 0;
+    mutable uint64_t m_costHash = 0;
+    mutable bool m_hashValid = true;
+};
+
+#endif // GRIDMAP_H
@@ -0,0 +1,91 @@
+#include "gridtextureitem.h"
+#include "pathfinder.h"
+#include <QQuickWindow>
+#include <QSGImageNode>
+
+GridTextureItem::GridTextureItem(QQuickItem *parent)
+    : QQuickItem(parent)
+{
+    setFlag(ItemHasContents, true);
+}
+
+void GridTextureItem::setCellModel(GridCellModel *model) {
+    if (m_model == model) {
+        return;
+    }
+
+    if (m_model) {
+        disconnect(m_model, nullptr, this, nullptr);
+    }
+    m_model = model;
+    if (m_model) {
+        connect(m_model, &QAbstractItemModel::modelReset, this, &GridTextureItem::rebuildImage);
+        connect(m_model, &QAbstractItemModel::dataChanged, this,
+                [this](const QModelIndex &topLeft, const QModelIndex &bottomRight) {
+            updateRows(topLeft.row(), bottomRight.row());
+        });
+    }
+
+    rebuildImage();
+    emit cellModelChanged();
+}
+
+QRgb GridTextureItem::colorFor(quint16 flags) {
+    if (flags & Pathfinder::CellObstacle) return qRgb(0x34, 0x49, 0x5e);
+    if (flags & Pathfinder::CellFinalPath) return qRgb(0x27, 0xae, 0x60);
+    if (flags & Pathfinder::CellClosed) return qRgb(0x9b, 0x59, 0xb6);
+    if (flags & Pathfinder::CellOpen) return qRgb(0x34, 0x98, 0xdb);
+    return qRgb(0xec, 0xf0, 0xf1);
+}
+
+void GridTextureItem::rebuildImage() {
+    int size = m_model ? m_model->gridSize() : 0;
+    if (size <= 0) {
+        m_image = QImage();
+    } else {
+        if (m_image.width() != size) {
+            m_image = QImage(size, size, QImage::Format_RGB32);
+        }
+        updateRows(0, size * size - 1);
+    }
+    m_textureDirty = true;
+    update();
+}
+
+void GridTextureItem::updateRows(int first, int last) {
+    if (m_image.isNull()) {
+        return;
+    }
+
+    // 模型的行就是行优先的单元格索引，连续区段通常落在同一条扫描线上
+    int size = m_image.width();
+    for (int index = first; index <= last; ++index) {
+        QRgb *line = reinterpret_cast<QRgb *>(m_image.scanLine(index / size));
+        line[index % size] = colorFor(m_model->cell(index).flags);
+    }
+    m_textureDirty = true;
+    update();
+}
+
+QSGNode *GridTextureItem::updatePaintNode(QSGNode *oldNode, UpdatePaintNodeData *) {
+    auto *node = static_cast<QSGImageNode *>(oldNode);
+    if (m_image.isNull() || width() <= 0 || height() <= 0) {
+        delete node;
+        return nullptr;
+    }
+
+    if (!node) {
+        node = window()->createImageNode();
+        node->setOwnsTexture(true);
+        node->setFiltering(QSGTexture::Nearest);
+        m_textureDirty = true;
+    }
+
+    // 渲染线程调用时 GUI 线程处于阻塞状态，可以直接读取图像
+    if (m_textureDirty) {
+        node->setTexture(window()->createTextureFromImage(m_image));
+        m_textureDirty = false;
+    }
+    node->setRect(boundingRect());
+    return node;
+}
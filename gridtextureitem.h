@@ -0,0 +1,41 @@
+#ifndef GRIDTEXTUREITEM_H
+#define GRIDTEXTUREITEM_H
+
+#include <QQuickItem>
+#include <QImage>
+#include <QPointer>
+#include "gridcellmodel.h"
+
+// 把一个算法的单元格模型画成一张纹理：每个单元格对应图像中的一个像素，
+// 由场景图按最近邻方式放大到整个区域。无论网格多大都只有一个节点，
+// 软件渲染器下也能流畅显示上千乘上千的地图。
+// 模型发出 dataChanged 时只重写对应的像素，下一帧再整体上传纹理。
+class GridTextureItem : public QQuickItem {
+    Q_OBJECT
+    Q_PROPERTY(GridCellModel *cellModel READ cellModel WRITE setCellModel NOTIFY cellModelChanged)
+
+public:
+    explicit GridTextureItem(QQuickItem *parent = nullptr);
+
+    GridCellModel *cellModel() const { return m_model; }
+    void setCellModel(GridCellModel *model);
+
+    // 单元格状态对应的颜色，与 QML 图例一致
+    static QRgb colorFor(quint16 flags);
+
+signals:
+    void cellModelChanged();
+
+protected:
+    QSGNode *updatePaintNode(QSGNode *oldNode, UpdatePaintNodeData *data) override;
+
+private:
+    void rebuildImage();
+    void updateRows(int first, int last);
+
+    QPointer<GridCellModel> m_model;
+    QImage m_image;
+    bool m_textureDirty = false;
+};
+
+#endif // GRIDTEXTUREITEM_H
@@ -0,0 +1,56 @@
+#ifndef HEURISTICS_H
+#define HEURISTICS_H
+
+#include <algorithm>
+#include <cmath>
+
+// 启发函数策略。estimate<Neighborhood>(dx, dy) 返回到终点的估计代价，dx、dy 为坐标差的绝对值；
+// 代价单位取自邻域模型（直行 StraightCost、斜行 DiagonalCost）。
+// 搜索内核把启发函数作为模板参数，在编译期选定并内联，内层循环里没有间接调用。
+
+// 曼哈顿距离：四邻域下的精确下界；八邻域下会高估，不再保证最优
+struct Manhattan {
+    template <typename Neighborhood>
+    static int estimate(int dx, int dy) {
+        return Neighborhood::StraightCost * (dx + dy);
+    }
+};
+
+// 八角距离：八邻域下的精确下界；四邻域的斜行代价是两步直行，此时等于曼哈顿距离
+struct Octile {
+    template <typename Neighborhood>
+    static int estimate(int dx, int dy) {
+        return Neighborhood::StraightCost * std::max(dx, dy)
+             + (Neighborhood::DiagonalCost - Neighborhood::StraightCost) * std::min(dx, dy);
+    }
+};
+
+// 欧氏距离（向下取整）：任何邻域下都不会高估，但比八角距离松
+struct Euclidean {
+    template <typename Neighborhood>
+    static int estimate(int dx, int dy) {
+        return int(Neighborhood::StraightCost * std::sqrt(double(dx) * dx + double(dy) * dy));
+    }
+};
+
+// 切比雪夫距离：任何邻域下都不会高估
+struct Chebyshev {
+    template <typename Neighborhood>
+    static int estimate(int dx, int dy) {
+        return Neighborhood::StraightCost * std::max(dx, dy);
+    }
+};
+
+// 加权启发：Base 的估计值乘以 Numerator / Denominator。
+// 权重大于 1 时扩展的节点更少，Base 可采纳时路径代价不超过最优值的同样倍数
+template <typename Base, int Numerator, int Denominator = 1>
+struct Weighted {
+    static_assert(Numerator > 0 && Denominator > 0, "weight must be positive");
+
+    template <typename Neighborhood>
+    static int estimate(int dx, int dy) {
+        return Base::template estimate<Neighborhood>(dx, dy) * Numerator / Denominator;
+    }
+};
+
+#endif // HEURISTICS_H
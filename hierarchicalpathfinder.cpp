@@ -0,0 +1,389 @@
+#include "hierarchicalpathfinder.h"
+#include <algorithm>
+#include <cstdlib>
+
+namespace {
+
+// 短于这个长度的边界区段只在中点放一个入口，更长的在两端各放一个
+const int kMaxSingleEntranceLength = 6;
+
+// 抽象图上有大量 f 相同的节点，优先扩展 g 更大的（更接近终点的）可以少走很多平台
+long long searchKey(int f, int g) {
+    return (static_cast<long long>(f) << 32) - g;
+}
+
+}
+
+HierarchicalPathfinder::HierarchicalPathfinder(int clusterSize)
+    : m_clusterSize(std::max(clusterSize, 2))
+{
+}
+
+void HierarchicalPathfinder::build(const GridMap &map) {
+    m_map = map;
+    m_clustersX = (map.width() + m_clusterSize - 1) / m_clusterSize;
+    m_clustersY = (map.height() + m_clusterSize - 1) / m_clusterSize;
+
+    m_clusters.assign(size_t(m_clustersX) * m_clustersY, Cluster());
+    for (int cy = 0; cy < m_clustersY; ++cy) {
+        for (int cx = 0; cx < m_clustersX; ++cx) {
+            Cluster &cluster = m_clusters[size_t(cy) * m_clustersX + cx];
+            cluster.x0 = cx * m_clusterSize;
+            cluster.y0 = cy * m_clusterSize;
+            cluster.width = std::min(m_clusterSize, map.width() - cluster.x0);
+            cluster.height = std::min(m_clusterSize, map.height() - cluster.y0);
+        }
+    }
+
+    m_stride = m_clusterSize + 2;
+    size_t localCells = size_t(m_stride) * m_stride;
+    m_localOpen.assign(localCells, 0);
+    m_localDistance.assign(localCells, Infinity);
+    m_localParent.assign(localCells, -1);
+    m_queue.reserve(localCells);
+    m_loadedCluster = -1;
+
+    for (int k = 0; k < int(m_clusters.size()); ++k) {
+        collectEntrances(k, m_clusters[k].entrances);
+        computeDistances(k);
+    }
+    rebuildNodeIndex();
+}
+
+void HierarchicalPathfinder::setObstacle(int x, int y, bool obstacle) {
+    if (!m_map.contains(x, y) || m_map.isObstacle(x, y) == obstacle) {
+        return;
+    }
+    m_map.setObstacle(x, y, obstacle);
+    m_loadedCluster = -1;
+
+    // 簇内部变了要重算距离；边界上的入口可能变化，相邻簇的入口也要重新收集
+    int cx = x / m_clusterSize;
+    int cy = y / m_clusterSize;
+    int center = clusterOf(x, y);
+    static const int offsets[5][2] = { {0, 0}, {-1, 0}, {0, -1}, {0, 1}, {1, 0} };
+
+    std::vector<int> entrances;
+    for (const auto &offset : offsets) {
+        int nx = cx + offset[0];
+        int ny = cy + offset[1];
+        if (nx < 0 || nx >= m_clustersX || ny < 0 || ny >= m_clustersY) {
+            continue;
+        }
+
+        int k = ny * m_clustersX + nx;
+        collectEntrances(k, entrances);
+        if (k == center || entrances != m_clusters[k].entrances) {
+            m_clusters[k].entrances.swap(entrances);
+            computeDistances(k);
+        }
+    }
+    rebuildNodeIndex();
+}
+
+PathResult HierarchicalPathfinder::findPath(GridPoint start, GridPoint goal) {
+    PathResult result;
+    if (!m_map.isPassable(start.x, start.y) || !m_map.isPassable(goal.x, goal.y)) {
+        return result;
+    }
+
+    int startCell = m_map.index(start.x, start.y);
+    int goalCell = m_map.index(goal.x, goal.y);
+    if (startCell == goalCell) {
+        result.found = true;
+        result.path.push_back(start);
+        return result;
+    }
+
+    int startClusterIndex = clusterOf(start.x, start.y);
+    int goalClusterIndex = clusterOf(goal.x, goal.y);
+    const Cluster &startCluster = m_clusters[startClusterIndex];
+    const Cluster &goalCluster = m_clusters[goalClusterIndex];
+
+    // 把起点和终点临时接入抽象图：簇内 BFS 得到它们到本簇各入口的距离
+    searchCluster(startClusterIndex, startCell);
+    std::vector<int> startDistances;
+    for (int cell : startCluster.entrances) {
+        startDistances.push_back(m_localDistance[localIndex(startCluster, cell)]);
+    }
+    int directDistance = startClusterIndex == goalClusterIndex ? m_localDistance[localIndex(startCluster, goalCell)] : Infinity;
+
+    searchCluster(goalClusterIndex, goalCell);
+    std::vector<int> goalDistances;
+    for (int cell : goalCluster.entrances) {
+        goalDistances.push_back(m_localDistance[localIndex(goalCluster, cell)]);
+    }
+
+    // 抽象图上的 A*：入口节点之后追加起点和终点两个临时节点
+    int nodeCount = this->nodeCount();
+    int startNode = nodeCount;
+    int goalNode = nodeCount + 1;
+    m_g.assign(size_t(nodeCount) + 2, Infinity);
+    m_parent.assign(size_t(nodeCount) + 2, -1);
+    m_open.reset(nodeCount + 2);
+
+    auto cellOf = [&](int node) {
+        return node == startNode ? startCell : node == goalNode ? goalCell : m_nodeCell[node];
+    };
+    auto relax = [&](int from, int to, int cost) {
+        int g = m_g[from] + cost;
+        if (g >= m_g[to]) {
+            return;
+        }
+        m_g[to] = g;
+        m_parent[to] = from;
+        m_open.pushOrDecrease(to, searchKey(g + heuristic(cellOf(to), goal), g));
+    };
+
+    m_g[startNode] = 0;
+    m_open.push(startNode, searchKey(heuristic(startCell, goal), 0));
+
+    while (!m_open.empty()) {
+        int node = m_open.pop();
+        ++result.expanded;
+        if (node == goalNode) {
+            result.found = true;
+            break;
+        }
+
+        if (node == startNode) {
+            int first = m_firstNode[startClusterIndex];
+            for (int i = 0; i < int(startDistances.size()); ++i) {
+                if (startDistances[i] < Infinity) {
+                    relax(node, first + i, startDistances[i]);
+                }
+            }
+            if (directDistance < Infinity) {
+                relax(node, goalNode, directDistance);
+            }
+            continue;
+        }
+
+        int clusterIndex = m_nodeCluster[node];
+        const Cluster &cluster = m_clusters[clusterIndex];
+        int first = m_firstNode[clusterIndex];
+        int local = node - first;
+        int count = int(cluster.entrances.size());
+
+        // 簇内边：预先算好的入口间距离
+        for (int j = 0; j < count; ++j) {
+            int distance = cluster.distances[size_t(local) * count + j];
+            if (j != local && distance < Infinity) {
+                relax(node, first + j, distance);
+            }
+        }
+
+        // 簇间边：边界另一侧相邻的入口
+        int cell = m_nodeCell[node];
+        int x = cell % m_map.width();
+        int y = cell / m_map.width();
+        static const int offsets[4][2] = { {-1, 0}, {0, -1}, {0, 1}, {1, 0} };
+        for (const auto &offset : offsets) {
+            int nx = x + offset[0];
+            int ny = y + offset[1];
+            if (!m_map.isPassable(nx, ny) || clusterOf(nx, ny) == clusterIndex) {
+                continue;
+            }
+            int other = clusterOf(nx, ny);
+            int slot = entranceSlot(m_clusters[other], m_map.index(nx, ny));
+            if (slot >= 0) {
+                relax(node, m_firstNode[other] + slot, 1);
+            }
+        }
+
+        if (clusterIndex == goalClusterIndex && goalDistances[local] < Infinity) {
+            relax(node, goalNode, goalDistances[local]);
+        }
+    }
+
+    if (!result.found) {
+        return result;
+    }
+    result.cost = m_g[goalNode];
+
+    // 细化：把抽象路径上的每条边展开成簇内的逐格路径
+    std::vector<int> cells;
+    for (int node = goalNode; node != -1; node = m_parent[node]) {
+        cells.push_back(cellOf(node));
+    }
+    std::reverse(cells.begin(), cells.end());
+
+    int width = m_map.width();
+    result.path.push_back(start);
+    for (size_t i = 1; i < cells.size(); ++i) {
+        int from = cells[i - 1];
+        int to = cells[i];
+        bool crossesBorder = clusterOf(from % width, from / width) != clusterOf(to % width, to / width);
+        if (crossesBorder) {
+            result.path.push_back({to % width, to / width});
+        } else {
+            appendClusterPath(from, to, result.path);
+        }
+    }
+    return result;
+}
+
+int HierarchicalPathfinder::entranceSlot(const Cluster &cluster, int cell) const {
+    auto it = std::lower_bound(cluster.entrances.begin(), cluster.entrances.end(), cell);
+    if (it == cluster.entrances.end() || *it != cell) {
+        return -1;
+    }
+    return int(it - cluster.entrances.begin());
+}
+
+void HierarchicalPathfinder::collectEntrances(int clusterIndex, std::vector<int> &out) const {
+    out.clear();
+    const Cluster &cluster = m_clusters[clusterIndex];
+    int right = cluster.x0 + cluster.width - 1;
+    int bottom = cluster.y0 + cluster.height - 1;
+
+    // 两侧沿同一方向扫描，相邻两个簇在同一条边界上选出的位置一致
+    if (cluster.x0 > 0) {
+        scanBorder(cluster.x0, cluster.y0, cluster.x0 - 1, cluster.y0, 0, 1, cluster.height, out);
+    }
+    if (right + 1 < m_map.width()) {
+        scanBorder(right, cluster.y0, right + 1, cluster.y0, 0, 1, cluster.height, out);
+    }
+    if (cluster.y0 > 0) {
+        scanBorder(cluster.x0, cluster.y0, cluster.x0, cluster.y0 - 1, 1, 0, cluster.width, out);
+    }
+    if (bottom + 1 < m_map.height()) {
+        scanBorder(cluster.x0, bottom, cluster.x0, bottom + 1, 1, 0, cluster.width, out);
+    }
+
+    // 角上的格子可能同时是两条边界的入口
+    std::sort(out.begin(), out.end());
+    out.erase(std::unique(out.begin(), out.end()), out.end());
+}
+
+void HierarchicalPathfinder::scanBorder(int ownX, int ownY, int otherX, int otherY, int stepX, int stepY, int length, std::vector<int> &out) const {
+    int runStart = -1;
+    for (int i = 0; i <= length; ++i) {
+        bool open = i < length
+            && m_map.isPassable(ownX + i * stepX, ownY + i * stepY)
+            && m_map.isPassable(otherX + i * stepX, otherY + i * stepY);
+        if (open) {
+            if (runStart < 0) {
+                runStart = i;
+            }
+            continue;
+        }
+        if (runStart < 0) {
+            continue;
+        }
+
+        int runEnd = i - 1;
+        if (runEnd - runStart + 1 < kMaxSingleEntranceLength) {
+            int middle = runStart + (runEnd - runStart) / 2;
+            out.push_back(m_map.index(ownX + middle * stepX, ownY + middle * stepY));
+        } else {
+            out.push_back(m_map.index(ownX + runStart * stepX, ownY + runStart * stepY));
+            out.push_back(m_map.index(ownX + runEnd * stepX, ownY + runEnd * stepY));
+        }
+        runStart = -1;
+    }
+}
+
+void HierarchicalPathfinder::computeDistances(int clusterIndex) {
+    Cluster &cluster = m_clusters[clusterIndex];
+    int count = int(cluster.entrances.size());
+    cluster.distances.assign(size_t(count) * count, Infinity);
+
+    // 距离是对称的：从第 i 个入口出发的 BFS 只需填写 j >= i 的部分
+    for (int i = 0; i < count; ++i) {
+        cluster.distances[size_t(i) * count + i] = 0;
+        if (i + 1 == count) {
+            break;
+        }
+        searchCluster(clusterIndex, cluster.entrances[i]);
+        for (int j = i + 1; j < count; ++j) {
+            int distance = m_localDistance[localIndex(cluster, cluster.entrances[j])];
+            cluster.distances[size_t(i) * count + j] = distance;
+            cluster.distances[size_t(j) * count + i] = distance;
+        }
+    }
+}
+
+void HierarchicalPathfinder::rebuildNodeIndex() {
+    m_firstNode.resize(m_clusters.size());
+    m_nodeCell.clear();
+    m_nodeCluster.clear();
+    for (int k = 0; k < int(m_clusters.size()); ++k) {
+        m_firstNode[k] = int(m_nodeCell.size());
+        for (int cell : m_clusters[k].entrances) {
+            m_nodeCell.push_back(cell);
+            m_nodeCluster.push_back(k);
+        }
+    }
+}
+
+void HierarchicalPathfinder::loadCluster(int clusterIndex) {
+    if (m_loadedCluster == clusterIndex) {
+        return;
+    }
+    m_loadedCluster = clusterIndex;
+
+    // 一次从行位板取 64 格，簇外的格子（含四周一圈）都是墙
+    const Cluster &cluster = m_clusters[clusterIndex];
+    std::fill(m_localOpen.begin(), m_localOpen.end(), 0);
+    for (int ly = 0; ly < cluster.height; ++ly) {
+        uint8_t *row = &m_localOpen[size_t(ly + 1) * m_stride + 1];
+        for (int lx = 0; lx < cluster.width; lx += 64) {
+            uint64_t blocked = m_map.rowBits(cluster.x0 + lx, cluster.y0 + ly);
+            int count = std::min(64, cluster.width - lx);
+            for (int i = 0; i < count; ++i) {
+                row[lx + i] = uint8_t(((blocked >> i) & 1) == 0);
+            }
+        }
+    }
+}
+
+void HierarchicalPathfinder::searchCluster(int clusterIndex, int fromCell) {
+    loadCluster(clusterIndex);
+    std::fill(m_localDistance.begin(), m_localDistance.end(), Infinity);
+    m_queue.clear();
+
+    int from = localIndex(m_clusters[clusterIndex], fromCell);
+    m_localDistance[from] = 0;
+    m_localParent[from] = -1;
+    m_queue.push_back(from);
+
+    const int offsets[4] = { -1, -m_stride, m_stride, 1 };
+    for (size_t head = 0; head < m_queue.size(); ++head) {
+        int local = m_queue[head];
+        int distance = m_localDistance[local] + 1;
+        for (int offset : offsets) {
+            int neighbor = local + offset;
+            if (m_localOpen[neighbor] && m_localDistance[neighbor] == Infinity) {
+                m_localDistance[neighbor] = distance;
+                m_localParent[neighbor] = local;
+                m_queue.push_back(neighbor);
+            }
+        }
+    }
+}
+
+int HierarchicalPathfinder::localIndex(const Cluster &cluster, int cell) const {
+    int width = m_map.width();
+    return (cell / width - cluster.y0 + 1) * m_stride + (cell % width - cluster.x0 + 1);
+}
+
+void HierarchicalPathfinder::appendClusterPath(int fromCell, int toCell, std::vector<GridPoint> &path) {
+    int width = m_map.width();
+    int clusterIndex = clusterOf(fromCell % width, fromCell / width);
+    const Cluster &cluster = m_clusters[clusterIndex];
+    searchCluster(clusterIndex, fromCell);
+
+    // 从终点沿父节点回溯，再按正序追加（不含起点，它已经在路径里）
+    size_t begin = path.size();
+    int from = localIndex(cluster, fromCell);
+    for (int local = localIndex(cluster, toCell); local != from; local = m_localParent[local]) {
+        path.push_back({cluster.x0 + local % m_stride - 1, cluster.y0 + local / m_stride - 1});
+    }
+    std::reverse(path.begin() + long(begin), path.end());
+}
+
+int HierarchicalPathfinder::heuristic(int cell, GridPoint goal) const {
+    int width = m_map.width();
+    return std::abs(cell % width - goal.x) + std::abs(cell / width - goal.y);
+}
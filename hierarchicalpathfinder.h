@@ -0,0 +1,86 @@
+#ifndef HIERARCHICALPATHFINDER_H
+#define HIERARCHICALPATHFINDER_H
+
+#include "gridmap.h"
+#include "indexedheap.h"
+#include "pathengine.h"
+#include <climits>
+#include <cstdint>
+#include <vector>
+
+// 分层寻路（HPA*）：把地图切成固定大小的簇，在簇边界上放置入口节点，
+// 预先算好同一簇内入口之间的距离，组成一张小得多的抽象图。
+// 查询时先在抽象图上搜索，再在各个簇内把抽象边细化成逐格路径。
+// 结果是近似最优的，代价与簇的数量而不是地图面积成正比。
+class HierarchicalPathfinder {
+public:
+    static constexpr int DefaultClusterSize = 32;
+    static constexpr int Infinity = INT_MAX / 4;
+
+    explicit HierarchicalPathfinder(int clusterSize = DefaultClusterSize);
+
+    // 复制地图并构建整张抽象图
+    void build(const GridMap &map);
+
+    // 只重建这个格子所在的簇及其相邻簇
+    void setObstacle(int x, int y, bool obstacle);
+
+    // expanded 为抽象图上扩展的节点数
+    PathResult findPath(GridPoint start, GridPoint goal);
+
+    const GridMap &map() const { return m_map; }
+    int clusterSize() const { return m_clusterSize; }
+    int nodeCount() const { return int(m_nodeCell.size()); }
+
+private:
+    struct Cluster {
+        int x0 = 0;
+        int y0 = 0;
+        int width = 0;
+        int height = 0;
+        std::vector<int> entrances;   // 入口格子的索引，升序
+        std::vector<int> distances;   // 入口两两之间的簇内距离，entrances.size() 的平方
+    };
+
+    int clusterOf(int x, int y) const { return (y / m_clusterSize) * m_clustersX + x / m_clusterSize; }
+    int entranceSlot(const Cluster &cluster, int cell) const;
+
+    void collectEntrances(int cluster, std::vector<int> &out) const;
+    // 沿一条簇边界扫描两侧都可走的连续区段，把本侧的入口格子加入 out
+    void scanBorder(int ownX, int ownY, int otherX, int otherY, int stepX, int stepY, int length, std::vector<int> &out) const;
+    void computeDistances(int cluster);
+    void rebuildNodeIndex();
+
+    // 把簇的可走性载入一块四周留一圈墙的局部数组，BFS 时不必做边界检查
+    void loadCluster(int cluster);
+    // 簇内 BFS，距离和父节点按局部下标写入 m_localDistance / m_localParent
+    void searchCluster(int cluster, int fromCell);
+    int localIndex(const Cluster &cluster, int cell) const;
+    void appendClusterPath(int fromCell, int toCell, std::vector<GridPoint> &path);
+
+    int heuristic(int cell, GridPoint goal) const;
+
+    GridMap m_map;
+    int m_clusterSize;
+    int m_clustersX = 0;
+    int m_clustersY = 0;
+    std::vector<Cluster> m_clusters;
+
+    // 抽象节点编号：簇 k 的第 i 个入口为 m_firstNode[k] + i
+    std::vector<int> m_firstNode;
+    std::vector<int> m_nodeCell;
+    std::vector<int> m_nodeCluster;
+
+    // 查询与构建时复用的临时内存
+    int m_stride = 0;                 // 局部数组的行宽（簇边长 + 2）
+    int m_loadedCluster = -1;
+    std::vector<uint8_t> m_localOpen;
+    std::vector<int> m_localDistance;
+    std::vector<int> m_localParent;
+    std::vector<int> m_queue;
+    std::vector<int> m_g;
+    std::vector<int> m_parent;
+    IndexedHeap<long long> m_open;    // 键为 f 相同时偏向 g 更大的节点
+};
+
+#endif // HIERARCHICALPATHFINDER_H
@@ -0,0 +1,209 @@
+#include "incrementalplanner.h"
+#include <algorithm>
+#include <cstdlib>
+
+void IncrementalPlanner::reset(const GridMap &map, GridPoint start, GridPoint goal) {
+    m_map = map;
+    m_start = start;
+    m_goal = goal;
+    m_startIndex = map.isPassable(start.x, start.y) ? map.index(start.x, start.y) : -1;
+    m_goalIndex = map.contains(goal.x, goal.y) ? map.index(goal.x, goal.y) : -1;
+    m_km = 0;
+    m_expanded = 0;
+
+    m_g.assign(size_t(map.cellCount()), Infinity);
+    m_rhs.assign(size_t(map.cellCount()), Infinity);
+    m_open.reset(map.cellCount());
+
+    if (m_startIndex >= 0) {
+        m_rhs[m_startIndex] = 0;
+        m_open.push(m_startIndex, calculateKey(m_startIndex));
+    }
+}
+
+void IncrementalPlanner::setObstacle(int x, int y, bool obstacle) {
+    if (!m_map.contains(x, y) || m_map.isObstacle(x, y) == obstacle) {
+        return;
+    }
+
+    if (x == m_start.x && y == m_start.y) {
+        // 起点是搜索树的根，起点被挡住后整棵树都失效
+        m_map.setObstacle(x, y, obstacle);
+        reset(m_map, m_start, m_goal);
+        return;
+    }
+
+    m_map.setObstacle(x, y, obstacle);
+    int index = m_map.index(x, y);
+
+    // 进出该格子的边代价都变了：重新计算它和邻居的 rhs
+    int around[4];
+    int count = neighbors(index, around);
+    m_rhs[index] = computeRhs(index);
+    updateVertex(index);
+    for (int i = 0; i < count; ++i) {
+        int neighbor = around[i];
+        if (neighbor != m_startIndex) {
+            m_rhs[neighbor] = computeRhs(neighbor);
+            updateVertex(neighbor);
+        }
+    }
+}
+
+void IncrementalPlanner::setGoal(GridPoint goal) {
+    if (goal == m_goal) {
+        return;
+    }
+
+    // 启发值的目标点移动后，堆中的旧键值仍是新键值的下界；
+    // 累加 km 后出堆时再惰性修正，不需要重建整个堆
+    m_km += std::abs(goal.x - m_goal.x) + std::abs(goal.y - m_goal.y);
+    m_goal = goal;
+    m_goalIndex = m_map.contains(goal.x, goal.y) ? m_map.index(goal.x, goal.y) : -1;
+}
+
+void IncrementalPlanner::setStart(GridPoint start) {
+    if (start != m_start) {
+        reset(m_map, start, m_goal);
+    }
+}
+
+bool IncrementalPlanner::computePath() {
+    m_expanded = 0;
+    if (m_goalIndex < 0) {
+        return false;
+    }
+
+    while (!m_open.empty()
+           && (m_open.topKey() < calculateKey(m_goalIndex) || m_rhs[m_goalIndex] != m_g[m_goalIndex])) {
+        int current = m_open.top();
+        Key oldKey = m_open.topKey();
+        Key newKey = calculateKey(current);
+        if (oldKey < newKey) {
+            m_open.update(current, newKey);
+            continue;
+        }
+
+        ++m_expanded;
+        int around[4];
+        int count = neighbors(current, around);
+
+        if (m_g[current] > m_rhs[current]) {
+            // 过一致：g 值降到 rhs，向邻居传播更短的距离
+            m_g[current] = m_rhs[current];
+            m_open.remove(current);
+            for (int i = 0; i < count; ++i) {
+                int neighbor = around[i];
+                if (neighbor != m_startIndex && isPassable(neighbor) && m_g[current] + 1 < m_rhs[neighbor]) {
+                    m_rhs[neighbor] = m_g[current] + 1;
+                    updateVertex(neighbor);
+                }
+            }
+        } else {
+            // 欠一致：g 值作废，依赖它的邻居重新选择前驱
+            int oldG = m_g[current];
+            m_g[current] = Infinity;
+            if (current != m_startIndex) {
+                m_rhs[current] = computeRhs(current);
+            }
+            updateVertex(current);
+            for (int i = 0; i < count; ++i) {
+                int neighbor = around[i];
+                if (neighbor != m_startIndex && m_rhs[neighbor] == oldG + 1) {
+                    m_rhs[neighbor] = computeRhs(neighbor);
+                    updateVertex(neighbor);
+                }
+            }
+        }
+    }
+
+    return hasPath();
+}
+
+std::vector<GridPoint> IncrementalPlanner::path() const {
+    std::vector<GridPoint> result;
+    if (!hasPath()) {
+        return result;
+    }
+
+    // 从终点沿 g 值最小的邻居回溯到起点
+    int width = m_map.width();
+    int current = m_goalIndex;
+    result.push_back({current % width, current / width});
+    while (current != m_startIndex) {
+        int around[4];
+        int count = neighbors(current, around);
+        int best = -1;
+        for (int i = 0; i < count; ++i) {
+            int neighbor = around[i];
+            if (isPassable(neighbor) && (best < 0 || m_g[neighbor] < m_g[best])) {
+                best = neighbor;
+            }
+        }
+        if (best < 0 || m_g[best] >= m_g[current]) {
+            result.clear();
+            return result;
+        }
+        current = best;
+        result.push_back({current % width, current / width});
+    }
+
+    std::reverse(result.begin(), result.end());
+    return result;
+}
+
+int IncrementalPlanner::heuristic(int index) const {
+    int width = m_map.width();
+    return std::abs(index % width - m_goal.x) + std::abs(index / width - m_goal.y);
+}
+
+IncrementalPlanner::Key IncrementalPlanner::calculateKey(int index) const {
+    int best = std::min(m_g[index], m_rhs[index]);
+    if (best >= Infinity) {
+        return {Infinity, Infinity};
+    }
+    return {best + heuristic(index) + m_km, best};
+}
+
+int IncrementalPlanner::computeRhs(int index) const {
+    if (!isPassable(index)) {
+        return Infinity;
+    }
+
+    int around[4];
+    int count = neighbors(index, around);
+    int best = Infinity;
+    for (int i = 0; i < count; ++i) {
+        int neighbor = around[i];
+        if (isPassable(neighbor) && m_g[neighbor] < Infinity) {
+            best = std::min(best, m_g[neighbor] + 1);
+        }
+    }
+    return best;
+}
+
+void IncrementalPlanner::updateVertex(int index) {
+    bool inconsistent = m_g[index] != m_rhs[index];
+    if (inconsistent) {
+        Key key = calculateKey(index);
+        if (m_open.contains(index)) {
+            m_open.update(index, key);
+        } else {
+            m_open.push(index, key);
+        }
+    } else if (m_open.contains(index)) {
+        m_open.remove(index);
+    }
+}
+
+int IncrementalPlanner::neighbors(int index, int out[4]) const {
+    int width = m_map.width();
+    int x = index % width;
+    int y = index / width;
+    int count = 0;
+    if (x > 0) out[count++] = index - 1;
+    if (y > 0) out[count++] = index - width;
+    if (y + 1 < m_map.height()) out[count++] = index + width;
+    if (x + 1 < width) out[count++] = index + 1;
+    return count;
+}
@@ -0,0 +1,70 @@
+#ifndef INCREMENTALPLANNER_H
+#define INCREMENTALPLANNER_H
+
+#include "gridmap.h"
+#include "indexedheap.h"
+#include <climits>
+#include <vector>
+
+// 增量规划器（LPA* / D* Lite）：在多次编辑之间保留 g/rhs 值。
+// 障碍物变化或终点移动后只修复受影响的那部分节点，重新规划的代价与变化量成正比。
+// 搜索树以起点为根，因此移动终点很便宜（通过 km 修正堆中的旧键值），
+// 移动起点则需要重新初始化。
+class IncrementalPlanner {
+public:
+    static constexpr int Infinity = INT_MAX / 4;
+
+    // 重新初始化并丢弃所有已有的搜索状态
+    void reset(const GridMap &map, GridPoint start, GridPoint goal);
+
+    void setObstacle(int x, int y, bool obstacle);
+    void setGoal(GridPoint goal);
+    void setStart(GridPoint start);
+
+    // 修复最短路径，返回终点是否可达
+    bool computePath();
+
+    bool hasPath() const { return m_goalIndex >= 0 && m_g[m_goalIndex] < Infinity; }
+    int pathCost() const { return hasPath() ? m_g[m_goalIndex] : Infinity; }
+    std::vector<GridPoint> path() const;
+
+    // 最近一次 computePath 扩展的节点数
+    int lastExpanded() const { return m_expanded; }
+
+    const GridMap &map() const { return m_map; }
+    GridPoint start() const { return m_start; }
+    GridPoint goal() const { return m_goal; }
+
+private:
+    struct Key {
+        int primary;
+        int secondary;
+
+        bool operator<(const Key &other) const {
+            return primary < other.primary || (primary == other.primary && secondary < other.secondary);
+        }
+    };
+
+    bool isPassable(int index) const { return !m_map.isObstacle(index); }
+    int heuristic(int index) const;
+    Key calculateKey(int index) const;
+    int computeRhs(int index) const;
+    void updateVertex(int index);
+
+    // 四邻域，返回邻居个数
+    int neighbors(int index, int out[4]) const;
+
+    GridMap m_map;
+    GridPoint m_start;
+    GridPoint m_goal;
+    int m_startIndex = -1;
+    int m_goalIndex = -1;
+
+    std::vector<int> m_g;
+    std::vector<int> m_rhs;
+    IndexedHeap<Key> m_open;
+    int m_km = 0;
+    int m_expanded = 0;
+};
+
+#endif // INCREMENTALPLANNER_H
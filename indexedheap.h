@@ -0,0 +1,159 @@
+#ifndef INDEXEDHEAP_H
+#define INDEXEDHEAP_H
+
+#include <functional>
+#include <vector>
+
+// 带索引的 d 叉堆：元素是 [0, capacity) 范围内的单元格索引，
+// 记录每个元素在堆中的位置，因此支持真正的 decrease-key。
+// 比较器是模板参数，会被内联展开，不经过 std::function 的类型擦除调用。
+template <typename Key, typename Compare = std::less<Key>, int Arity = 4>
+class IndexedHeap {
+    static_assert(Arity >= 2, "IndexedHeap arity must be at least 2");
+
+public:
+    static constexpr int NotInHeap = -1;
+
+    IndexedHeap() = default;
+    explicit IndexedHeap(int capacity) { reset(capacity); }
+
+    // 清空并调整容量，之后可以放入 [0, capacity) 的任意元素。
+    // 容量不变时只清除仍在堆中的元素，代价与堆的大小成正比
+    void reset(int capacity) {
+        if (m_position.size() == size_t(capacity)) {
+            for (const Entry &entry : m_heap) {
+                m_position[entry.item] = NotInHeap;
+            }
+        } else {
+            m_position.assign(size_t(capacity), NotInHeap);
+        }
+        m_heap.clear();
+    }
+
+    bool empty() const { return m_heap.empty(); }
+    int size() const { return int(m_heap.size()); }
+    bool contains(int item) const { return m_position[item] != NotInHeap; }
+
+    int top() const { return m_heap.front().item; }
+    const Key& topKey() const { return m_heap.front().key; }
+    const Key& keyOf(int item) const { return m_heap[m_position[item]].key; }
+
+    void push(int item, const Key &key) {
+        m_heap.push_back({key, item});
+        m_position[item] = int(m_heap.size()) - 1;
+        siftUp(int(m_heap.size()) - 1);
+    }
+
+    int pop() {
+        int item = m_heap.front().item;
+        m_position[item] = NotInHeap;
+
+        Entry last = m_heap.back();
+        m_heap.pop_back();
+        if (!m_heap.empty()) {
+            m_heap.front() = last;
+            m_position[last.item] = 0;
+            siftDown(0);
+        }
+        return item;
+    }
+
+    // 新键不得比原键更差（相等也允许）
+    void decreaseKey(int item, const Key &key) {
+        int pos = m_position[item];
+        m_heap[pos].key = key;
+        siftUp(pos);
+    }
+
+    // 任意修改键值（可升可降）
+    void update(int item, const Key &key) {
+        int pos = m_position[item];
+        bool decreased = m_less(key, m_heap[pos].key);
+        m_heap[pos].key = key;
+        if (decreased) {
+            siftUp(pos);
+        } else {
+            siftDown(pos);
+        }
+    }
+
+    // 从堆中删除任意元素
+    void remove(int item) {
+        int pos = m_position[item];
+        m_position[item] = NotInHeap;
+
+        Entry last = m_heap.back();
+        m_heap.pop_back();
+        if (pos < int(m_heap.size())) {
+            m_heap[pos] = last;
+            m_position[last.item] = pos;
+            siftUp(pos);
+            siftDown(m_position[last.item]);
+        }
+    }
+
+    // 不在堆中则插入，否则降低键值
+    void pushOrDecrease(int item, const Key &key) {
+        if (contains(item)) {
+            decreaseKey(item, key);
+        } else {
+            push(item, key);
+        }
+    }
+
+private:
+    struct Entry {
+        Key key;
+        int item;
+    };
+
+    void siftUp(int pos) {
+        Entry entry = m_heap[pos];
+        while (pos > 0) {
+            int parent = (pos - 1) / Arity;
+            if (!m_less(entry.key, m_heap[parent].key)) {
+                break;
+            }
+            m_heap[pos] = m_heap[parent];
+            m_position[m_heap[pos].item] = pos;
+            pos = parent;
+        }
+        m_heap[pos] = entry;
+        m_position[entry.item] = pos;
+    }
+
+    void siftDown(int pos) {
+        int count = int(m_heap.size());
+        Entry entry = m_heap[pos];
+        for (;;) {
+            int first = pos * Arity + 1;
+            if (first >= count) {
+                break;
+            }
+
+            // 在所有子节点中找出最小的一个
+            int last = first + Arity < count ? first + Arity : count;
+            int best = first;
+            for (int child = first + 1; child < last; ++child) {
+                if (m_less(m_heap[child].key, m_heap[best].key)) {
+                    best = child;
+                }
+            }
+
+            if (!m_less(m_heap[best].key, entry.key)) {
+                break;
+            }
+            m_heap[pos] = m_heap[best];
+            m_position[m_heap[pos].item] = pos;
+            pos = best;
+        }
+        m_heap[pos] = entry;
+        m_position[entry.item] = pos;
+    }
+
+    std::vector<Entry> m_heap;
+    std::vector<int> m_position;
+    Compare m_less;
+};
+
+#endif // INDEXEDHEAP_H
@@ -0,0 +1,118 @@
+#include "jumptable.h"
+#include "bitscan.h"
+
+namespace {
+
+// 从相邻格的距离推出本格的距离：相邻格本身是跳点记 1，否则在它的距离上再走一格
+int extend(int next) {
+    return next > 0 ? next + 1 : next - 1;
+}
+
+}
+
+void JumpTable::build(const GridMap &map) {
+    m_width = map.width();
+    m_height = map.height();
+    m_distances.assign(size_t(map.cellCount()) * DirectionCount, 0);
+
+    // 水平方向：每一行从扫描终点往回递推，整张表是线性时间
+    for (int y = 0; y < m_height; ++y) {
+        for (int x = m_width - 1; x >= 0; --x) {
+            int next = x + 1;
+            int &east = at(map.index(x, y), East);
+            if (!map.isPassable(next, y)) {
+                east = 0;
+            } else if (hasForcedNeighbor(map, next, y, 1)) {
+                east = 1;
+            } else {
+                east = extend(at(map.index(next, y), East));
+            }
+        }
+        for (int x = 0; x < m_width; ++x) {
+            int next = x - 1;
+            int &west = at(map.index(x, y), West);
+            if (!map.isPassable(next, y)) {
+                west = 0;
+            } else if (hasForcedNeighbor(map, next, y, -1)) {
+                west = 1;
+            } else {
+                west = extend(at(map.index(next, y), West));
+            }
+        }
+    }
+
+    // 垂直方向：某格向左或向右能扫到（与终点无关的）跳点时，它就是垂直方向的跳点
+    auto isVerticalJumpPoint = [&](int x, int y) {
+        int index = map.index(x, y);
+        return at(index, East) > 0 || at(index, West) > 0;
+    };
+
+    for (int x = 0; x < m_width; ++x) {
+        for (int y = 0; y < m_height; ++y) {
+            int next = y - 1;
+            int &north = at(map.index(x, y), North);
+            if (!map.isPassable(x, next)) {
+                north = 0;
+            } else if (isVerticalJumpPoint(x, next)) {
+                north = 1;
+            } else {
+                north = extend(at(map.index(x, next), North));
+            }
+        }
+        for (int y = m_height - 1; y >= 0; --y) {
+            int next = y + 1;
+            int &south = at(map.index(x, y), South);
+            if (!map.isPassable(x, next)) {
+                south = 0;
+            } else if (isVerticalJumpPoint(x, next)) {
+                south = 1;
+            } else {
+                south = extend(at(map.index(x, next), South));
+            }
+        }
+    }
+}
+
+int JumpTable::scanRow(const GridMap &map, int x, int y, int dx) {
+    if (dx > 0) {
+        // 窗口第 i 位对应 base + i；第 0 位是上一个窗口的最后一格，只用来判断强制邻居
+        for (int base = x;; base += 63) {
+            uint64_t row = map.rowBits(base, y);
+            uint64_t above = map.rowBits(base, y - 1);
+            uint64_t below = map.rowBits(base, y + 1);
+
+            // 强制邻居：旁边一格可走，而它左边一格被挡住
+            uint64_t forced = ((~above & (above << 1)) | (~below & (below << 1))) & ~uint64_t(1);
+            uint64_t walls = row & ~uint64_t(1);
+
+            int wall = walls ? countTrailingZeros(walls) : 64;
+            int jumpPoint = forced ? countTrailingZeros(forced) : 64;
+            if (jumpPoint < wall) {
+                return base + jumpPoint - x;
+            }
+            if (wall < 64) {
+                return -(base + wall - 1 - x);
+            }
+        }
+    }
+
+    // 向西：窗口第 63 位对应 end，第 j 位对应 end - 63 + j
+    for (int end = x;; end -= 63) {
+        uint64_t row = map.rowBits(end - 63, y);
+        uint64_t above = map.rowBits(end - 63, y - 1);
+        uint64_t below = map.rowBits(end - 63, y + 1);
+
+        const uint64_t self = uint64_t(1) << 63;
+        uint64_t forced = ((~above & (above >> 1)) | (~below & (below >> 1))) & ~self;
+        uint64_t walls = row & ~self;
+
+        int wall = walls ? countLeadingZeros(walls) : 64;
+        int jumpPoint = forced ? countLeadingZeros(forced) : 64;
+        if (jumpPoint < wall) {
+            return x - end + jumpPoint;
+        }
+        if (wall < 64) {
+            return -(x - end + wall - 1);
+        }
+    }
+}
@@ -0,0 +1,57 @@
+#ifndef JUMPTABLE_H
+#define JUMPTABLE_H
+
+#include "gridmap.h"
+#include <cstddef>
+#include <vector>
+
+// 四邻域网格上的跳点搜索（JPS）规则：
+// - 水平移动时，若某格上方/下方可走、而它身后那一格的同侧被挡住，则该格有强制邻居，是跳点；
+// - 垂直移动时，每一格都向左右两侧做水平扫描，任一侧找到跳点则该格是跳点。
+//
+// JumpTable 是 JPS+ 的预计算表：对每个单元格的四个方向记录到下一个跳点或墙的距离，
+// 搜索时一次查表代替逐格扫描。表与终点无关，终点检查在搜索时进行。
+class JumpTable {
+public:
+    enum Direction {
+        West,
+        North,
+        South,
+        East,
+        DirectionCount
+    };
+
+    JumpTable() = default;
+    explicit JumpTable(const GridMap &map) { build(map); }
+
+    // 地图修改后需要重新构建
+    void build(const GridMap &map);
+
+    int width() const { return m_width; }
+    int height() const { return m_height; }
+
+    // > 0：沿该方向第 n 格是跳点；<= 0：沿该方向还能走 -n 格，之后是墙或边界
+    int distance(int index, Direction direction) const { return m_distances[size_t(index) * DirectionCount + direction]; }
+
+    static Direction directionOf(int dx, int dy) {
+        return dx < 0 ? West : dx > 0 ? East : dy < 0 ? North : South;
+    }
+
+    // 沿水平方向 dx 进入 (x, y) 时是否有强制邻居
+    static bool hasForcedNeighbor(const GridMap &map, int x, int y, int dx) {
+        return (map.isPassable(x, y - 1) && !map.isPassable(x - dx, y - 1))
+            || (map.isPassable(x, y + 1) && !map.isPassable(x - dx, y + 1));
+    }
+
+    // 不查表的在线版本：用行位板一次检查 63 格的墙和强制邻居，返回值含义与 distance() 相同
+    static int scanRow(const GridMap &map, int x, int y, int dx);
+
+private:
+    int &at(int index, Direction direction) { return m_distances[size_t(index) * DirectionCount + direction]; }
+
+    int m_width = 0;
+    int m_height = 0;
+    std::vector<int> m_distances;
+};
+
+#endif // JUMPTABLE_H
@@ -0,0 +1,231 @@
+#include "landmarks.h"
+#include "componentindex.h"
+#include "mappedfile.h"
+#include <cstdio>
+#include <cstring>
+
+namespace {
+
+const char kMagic[8] = { 'A', 'S', 'T', 'A', 'R', 'A', 'L', 'T' };
+const uint32_t kVersion = 1;
+const uint32_t kSymmetric = 0x1;
+const uint64_t kAlignment = 64;
+
+// 文件头，固定 64 字节；之后是 count 个地标索引（int32），再按 64 字节对齐放距离表
+struct Header {
+    char magic[8];
+    uint32_t version;
+    uint32_t neighborhood;
+    int32_t width;
+    int32_t height;
+    uint32_t count;
+    uint32_t flags;
+    uint64_t mapHash;
+    uint64_t landmarkOffset;
+    uint64_t distanceOffset;
+    uint64_t fileSize;
+};
+static_assert(sizeof(Header) == 64, "landmark file header must stay 64 bytes");
+
+uint64_t alignUp(uint64_t value) {
+    return (value + kAlignment - 1) / kAlignment * kAlignment;
+}
+
+// 空的区段不调用 fwrite：空 vector 的 data() 可能是空指针
+bool writeBytes(FILE *file, const void *data, size_t size) {
+    return size == 0 || std::fwrite(data, 1, size, file) == size;
+}
+
+// [offset, offset + size) 完整落在长为 fileSize 的文件内；先比较偏移，相加不会溢出
+bool fitsInFile(uint64_t offset, uint64_t size, uint64_t fileSize) {
+    return offset <= fileSize && size <= fileSize - offset;
+}
+
+void setError(std::string *error, const std::string &message) {
+    if (error) {
+        *error = message;
+    }
+}
+
+}
+
+void LandmarkTable::beginBuild(const GridMap &map, int neighborhood, int count) {
+    m_width = map.width();
+    m_height = map.height();
+    m_count = std::max(0, std::min(count, MaxLandmarks));
+    m_neighborhood = neighborhood;
+    m_symmetric = !map.hasCosts();
+    m_mapHash = map.contentHash();
+    m_landmarks.clear();
+    m_distances.assign(size_t(map.cellCount()) * m_count, Unreachable);
+    m_data = m_distances.data();
+    m_owner.reset();
+}
+
+void LandmarkTable::storeLandmark(int slot, int cell, const std::vector<int> &distances, std::vector<int> &nearest) {
+    m_landmarks.push_back(cell);
+    for (size_t index = 0; index < distances.size(); ++index) {
+        int distance = distances[index];
+        if (distance == INT_MAX) {
+            continue;
+        }
+        m_distances[index * m_count + slot] = uint16_t(std::min(distance, int(MaxDistance)));
+        nearest[index] = std::min(nearest[index], distance);
+    }
+}
+
+bool LandmarkTable::finishBuild(int built, std::string *error) {
+    int requested = m_count;
+    // 分量里的可走格比要求的地标还少时，把每格的前 built 个值紧凑到一起
+    if (built < m_count) {
+        size_t cells = size_t(m_width) * m_height;
+        for (size_t index = 0; index < cells; ++index) {
+            for (int slot = 0; slot < built; ++slot) {
+                m_distances[index * built + slot] = m_distances[index * m_count + slot];
+            }
+        }
+        m_distances.resize(cells * built);
+        m_distances.shrink_to_fit();
+        m_count = built;
+    }
+    m_data = m_distances.data();
+    if (built == 0) {
+        setError(error, requested == 0 ? "landmark count must be at least 1" : "map has no passable cell for a landmark");
+        return false;
+    }
+    return true;
+}
+
+int LandmarkTable::largestComponentCell(const GridMap &map, bool diagonal) {
+    ComponentIndex components(map, diagonal ? ComponentIndex::Diagonal : ComponentIndex::Orthogonal);
+    // 刚建好的索引里分量编号都小于格子数
+    std::vector<int> sizes(size_t(map.cellCount()), 0);
+    std::vector<int> firstCells(size_t(map.cellCount()), -1);
+    int best = -1;
+    int bestSize = 0;
+    for (int index = 0; index < map.cellCount(); ++index) {
+        int component = components.component(index);
+        if (component < 0) {
+            continue;
+        }
+        if (firstCells[component] < 0) {
+            firstCells[component] = index;
+        }
+        if (++sizes[component] > bestSize) {
+            best = firstCells[component];
+            bestSize = sizes[component];
+        }
+    }
+    return best;
+}
+
+int LandmarkTable::farthestCell(const std::vector<int> &distances) {
+    int best = -1;
+    int bestDistance = 0;
+    for (size_t index = 0; index < distances.size(); ++index) {
+        int distance = distances[index];
+        if (distance == INT_MAX) {
+            continue;
+        }
+        if (distance > bestDistance) {
+            best = index;
+            bestDistance = distance;
+        }
+    }
+    return best;
+}
+
+bool LandmarkTable::save(const std::string &path, std::string *error) const {
+    // build() 失败时表为空；open() 要求至少一个地标，这里直接拒绝
+    if (isEmpty()) {
+        setError(error, "landmark table is empty");
+        return false;
+    }
+    uint64_t landmarkBytes = uint64_t(m_count) * sizeof(int32_t);
+    uint64_t distanceBytes = memoryBytes();
+
+    Header header = {};
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kVersion;
+    header.neighborhood = uint32_t(m_neighborhood);
+    header.width = m_width;
+    header.height = m_height;
+    header.count = uint32_t(m_count);
+    header.flags = m_symmetric ? kSymmetric : 0;
+    header.mapHash = m_mapHash;
+    header.landmarkOffset = sizeof(Header);
+    header.distanceOffset = alignUp(header.landmarkOffset + landmarkBytes);
+    header.fileSize = header.distanceOffset + distanceBytes;
+
+    FILE *file = std::fopen(path.c_str(), "wb");
+    if (!file) {
+        setError(error, "cannot create " + path);
+        return false;
+    }
+    std::vector<int32_t> landmarks(m_landmarks.begin(), m_landmarks.end());
+    std::vector<char> padding(size_t(header.distanceOffset - header.landmarkOffset - landmarkBytes), 0);
+    bool ok = std::fwrite(&header, sizeof(header), 1, file) == 1
+           && writeBytes(file, landmarks.data(), size_t(landmarkBytes))
+           && writeBytes(file, padding.data(), padding.size())
+           && writeBytes(file, m_data, size_t(distanceBytes));
+    ok = std::fclose(file) == 0 && ok;
+    if (!ok) {
+        setError(error, "cannot write " + path);
+    }
+    return ok;
+}
+
+bool LandmarkTable::openFile(const std::string &path, const GridMap &map, int neighborhood, std::string *error) {
+    auto file = std::make_shared<MappedFile>();
+    if (!file->open(path)) {
+        setError(error, "cannot map " + path);
+        return false;
+    }
+    if (file->size() < sizeof(Header)) {
+        setError(error, path + " is too small to be a landmark file");
+        return false;
+    }
+
+    Header header;
+    std::memcpy(&header, file->data(), sizeof(header));
+    if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0 || header.version != kVersion) {
+        setError(error, path + " is not a landmark file of a supported version");
+        return false;
+    }
+    if (header.width != map.width() || header.height != map.height() || header.mapHash != map.contentHash()) {
+        setError(error, path + " was built for a different map");
+        return false;
+    }
+    if (int(header.neighborhood) != neighborhood) {
+        setError(error, path + " was built for a different neighborhood");
+        return false;
+    }
+
+    uint64_t distanceBytes = uint64_t(map.cellCount()) * header.count * sizeof(uint16_t);
+    bool valid = header.count >= 1 && header.count <= uint32_t(MaxLandmarks)
+              && header.landmarkOffset >= sizeof(Header)
+              && fitsInFile(header.landmarkOffset, uint64_t(header.count) * sizeof(int32_t), file->size())
+              && header.distanceOffset % kAlignment == 0
+              && fitsInFile(header.distanceOffset, distanceBytes, file->size());
+    if (!valid) {
+        setError(error, path + " is truncated or corrupt");
+        return false;
+    }
+
+    const char *base = file->data();
+    std::vector<int32_t> landmarks(header.count);
+    std::memcpy(landmarks.data(), base + header.landmarkOffset, landmarks.size() * sizeof(int32_t));
+
+    m_width = header.width;
+    m_height = header.height;
+    m_count = int(header.count);
+    m_neighborhood = neighborhood;
+    m_symmetric = header.flags & kSymmetric;
+    m_mapHash = header.mapHash;
+    m_landmarks.assign(landmarks.begin(), landmarks.end());
+    m_distances.clear();
+    m_distances.shrink_to_fit();
+    m_data = reinterpret_cast<const uint16_t *>(base + header.distanceOffset);
+    m_owner = file;
+    return true;
+}
@@ -0,0 +1,173 @@
+#ifndef LANDMARKS_H
+#define LANDMARKS_H
+
+#include "gridmap.h"
+#include "indexedheap.h"
+#include "neighborhoods.h"
+#include <algorithm>
+#include <climits>
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <vector>
+
+// ALT（A*, Landmarks, Triangle inequality）预计算表：选 K 个地标，记录每个地标到所有格子的最短距离。
+// 对任意格子 v 和终点 t，三角不等式给出 d(v, t) >= d(L, t) - d(L, v)；统一代价地图上距离对称，
+// 还有 d(v, t) >= d(L, v) - d(L, t)。取所有地标中最大的一个作为启发值，它仍然是一致的，
+// 在迷宫和室内地图上比曼哈顿、八角距离紧得多。
+//
+// 距离按格子连续存放，每格 K 个 16 位值，一次估价只读一条缓存行。超过 MaxDistance 的距离截断为
+// MaxDistance：截断不会让下界变大，启发值仍然可采纳且一致，只是远处变松。
+// 表可以存成文件并按内存映射打开，大地图的预处理只做一次。
+class LandmarkTable {
+public:
+    static constexpr int MaxLandmarks = 32;
+    static constexpr int MaxDistance = 0xFFFE;
+    static constexpr uint16_t Unreachable = 0xFFFF;
+
+    LandmarkTable() = default;
+    LandmarkTable(const LandmarkTable &) = delete;
+    LandmarkTable &operator=(const LandmarkTable &) = delete;
+
+    // 在最大的连通分量里用最远点策略选 count 个地标（第一个离分量内行优先的第一格最远，
+    // 之后每个离已选地标最远），再从每个地标跑一遍 Dijkstra。代价为 count + 1 次分量内的
+    // Dijkstra；距离单位与邻域一致。其它分量里的格子与所有地标都不连通，下界退化为 0。
+    // count 小于 1 或地图上没有可走格时表为空，返回 false 并在 error 不为空时写入原因
+    template <typename Neighborhood = FourConnected>
+    bool build(const GridMap &map, int count, std::string *error = nullptr);
+
+    // 写出表；表为空（build() 失败）或写入失败时返回 false，并在 error 不为空时写入原因
+    bool save(const std::string &path, std::string *error = nullptr) const;
+
+    // 映射打开表文件，不复制数据；文件必须由内容相同的地图（按 GridMap::contentHash 比较）
+    // 和同一种邻域构建，否则返回 false，表保持不变
+    template <typename Neighborhood = FourConnected>
+    bool open(const std::string &path, const GridMap &map, std::string *error = nullptr) {
+        return openFile(path, map, Neighborhood::Id, error);
+    }
+
+    bool isEmpty() const { return m_count == 0; }
+    bool isMapped() const { return m_owner != nullptr; }
+    int count() const { return m_count; }
+    int width() const { return m_width; }
+    int height() const { return m_height; }
+    const std::vector<int> &landmarks() const { return m_landmarks; }
+    size_t memoryBytes() const { return size_t(m_width) * m_height * m_count * sizeof(uint16_t); }
+
+    // 这张表能否用于在 map 上按该邻域搜索（尺寸和邻域一致；内容是否一致由调用方保证）
+    template <typename Neighborhood>
+    bool appliesTo(const GridMap &map) const {
+        return m_count > 0 && m_neighborhood == Neighborhood::Id && map.width() == m_width && map.height() == m_height;
+    }
+
+    // 一次查询开始时取出终点一行（count() 个值），之后每次估价都与它比较
+    void loadRow(int index, uint16_t *row) const {
+        std::copy(m_data + size_t(index) * m_count, m_data + size_t(index + 1) * m_count, row);
+    }
+
+    // (x, y) 到终点的下界；goalRow 由 loadRow 取得。与某个地标不连通的一侧不参与比较
+    int lowerBound(const uint16_t *goalRow, int x, int y) const {
+        const uint16_t *row = m_data + size_t(y * m_width + x) * m_count;
+        int best = 0;
+        for (int i = 0; i < m_count; ++i) {
+            int toGoal = goalRow[i];
+            int toCell = row[i];
+            if (toGoal == Unreachable || toCell == Unreachable) {
+                continue;
+            }
+            int bound = m_symmetric ? std::abs(toGoal - toCell) : toGoal - toCell;
+            best = std::max(best, bound);
+        }
+        return best;
+    }
+
+private:
+    // 从 source 出发的单源最短距离，不可达为 INT_MAX
+    template <typename Neighborhood>
+    static void distancesFrom(const GridMap &map, int source, std::vector<int> &distances);
+
+    // 以下是与邻域无关的部分，在 landmarks.cpp 中实现
+    void beginBuild(const GridMap &map, int neighborhood, int count);
+    void storeLandmark(int slot, int cell, const std::vector<int> &distances, std::vector<int> &nearest);
+    bool finishBuild(int built, std::string *error);
+    // 最大的连通分量里行优先的第一格，没有可走格时返回 -1；diagonal 与 Neighborhood::ConnectsDiagonally 一致
+    static int largestComponentCell(const GridMap &map, bool diagonal);
+    // distances 中有限值最大的格子，不可达（INT_MAX）的格子不参与；最大值为 0 时返回 -1
+    static int farthestCell(const std::vector<int> &distances);
+    bool openFile(const std::string &path, const GridMap &map, int neighborhood, std::string *error);
+
+    int m_width = 0;
+    int m_height = 0;
+    int m_count = 0;
+    int m_neighborhood = 0;
+    bool m_symmetric = true;               // 没有代价层时距离对称，可以用两个方向的下界
+    uint64_t m_mapHash = 0;
+    std::vector<int> m_landmarks;          // 地标的单元格索引
+    std::vector<uint16_t> m_distances;     // 自己构建的表，按格子连续存放
+    const uint16_t *m_data = nullptr;      // 指向 m_distances 或映射的文件
+    std::shared_ptr<const void> m_owner;   // 映射文件的所有者，为空表示数据在 m_distances 里
+};
+
+template <typename Neighborhood>
+bool LandmarkTable::build(const GridMap &map, int count, std::string *error) {
+    beginBuild(map, Neighborhood::Id, count);
+
+    // 行优先的第一个可走格可能是一个孤立的小角落，从那里出发选不出有用的地标
+    int seed = m_count > 0 ? largestComponentCell(map, Neighborhood::ConnectsDiagonally) : -1;
+    if (seed < 0) {
+        return finishBuild(0, error);
+    }
+
+    std::vector<int> distances;
+    std::vector<int> nearest(size_t(map.cellCount()), INT_MAX);
+    distancesFrom<Neighborhood>(map, seed, distances);
+    // 分量只有一格时地标就放在种子上
+    int next = farthestCell(distances);
+    if (next < 0) {
+        next = seed;
+    }
+
+    // nearest 只在已选地标能到达的格子上有限，最远点总是留在这个分量里
+    int built = 0;
+    for (; built < m_count && next >= 0; ++built) {
+        distancesFrom<Neighborhood>(map, next, distances);
+        storeLandmark(built, next, distances, nearest);
+        next = farthestCell(nearest);
+    }
+    return finishBuild(built, error);
+}
+
+template <typename Neighborhood>
+void LandmarkTable::distancesFrom(const GridMap &map, int source, std::vector<int> &distances) {
+    distances.assign(size_t(map.cellCount()), INT_MAX);
+    IndexedHeap<int> open(map.cellCount());
+    distances[source] = 0;
+    open.push(source, 0);
+
+    while (!open.empty()) {
+        int current = open.pop();
+        int x = current % map.width();
+        int y = current / map.width();
+        for (const auto &offset : Neighborhood::Offsets) {
+            int nx = x + offset[0];
+            int ny = y + offset[1];
+            if (!map.isPassable(nx, ny) || !Neighborhood::canMove(map, x, y, offset[0], offset[1])) {
+                continue;
+            }
+            int neighbor = map.index(nx, ny);
+            int distance = distances[current] + Neighborhood::cost(offset[0], offset[1]) * map.cost(neighbor);
+            if (distance >= distances[neighbor]) {
+                continue;
+            }
+            if (open.contains(neighbor)) {
+                open.decreaseKey(neighbor, distance);
+            } else {
+                open.push(neighbor, distance);
+            }
+            distances[neighbor] = distance;
+        }
+    }
+}
+
+#endif // LANDMARKS_H
@@ -3,6 +3,7 @@
 #include <QQmlApplicationEngine>
 #include <QIcon>
 #include "pathfinder.h"
+#include "gridtextureitem.h"
 
 int main(int argc, char *argv[]) {
     QGuiApplication app(argc, argv);
@@ -11,6 +12,8 @@ int main(int argc, char *argv[]) {
     app.setWindowIcon(QIcon(":/logo.ico"));  // 从资源文件加载
     
     qmlRegisterType<Pathfinder>("AStar", 1, 0, "Pathfinder");
+    qmlRegisterUncreatableType<GridCellModel>("AStar", 1, 0, "GridCellModel", "由 Pathfinder 提供");
+    qmlRegisterType<GridTextureItem>("AStar", 1, 0, "GridTextureItem");
     QQuickStyle::setStyle("Fusion");
     QQmlApplicationEngine engine;
     engine.load(QUrl(QStringLiteral("qrc:/main.qml")));
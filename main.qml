@@ -2,11 +2,12 @@ import QtQuick
 import QtQuick.Window
 import QtQuick.Controls
 import QtQuick.Layouts
+import QtQuick.Dialogs
 import AStar 1.0
 
 Window {
     id: root
-    width: 1200
+    width: 1500
     height: 900
     minimumWidth: 1000
     minimumHeight: 800
@@ -19,13 +20,6 @@ Window {
         
         onGridChanged: {
             console.log("Grid changed, progress:", progress)
-            // 强制刷新所有网格
-            dijkstraGridRepeater.model = 0
-            dijkstraGridRepeater.model = pathfinder.gridSize * pathfinder.gridSize
-            greedyGridRepeater.model = 0  
-            greedyGridRepeater.model = pathfinder.gridSize * pathfinder.gridSize
-            aStarGridRepeater.model = 0
-            aStarGridRepeater.model = pathfinder.gridSize * pathfinder.gridSize
         }
         
         onProgressChanged: {
@@ -33,6 +27,94 @@ Window {
         }
     }
 
+    // 一个算法的网格：颜色由 GridTextureItem 画成一张纹理，
+    // 只有小网格才为每个单元格创建代理项来显示数值和边框
+    component CellGrid : GridTextureItem {
+        id: cellGrid
+        required property string valueRole
+        readonly property bool showLabels: pathfinder.gridSize <= 40
+
+        anchors.centerIn: parent
+        // 确保网格本身是正方形
+        property real cellSize: Math.min(parent.width, parent.height) / pathfinder.gridSize
+        width: cellSize * pathfinder.gridSize
+        height: cellSize * pathfinder.gridSize
+
+        Repeater {
+            // 进度变化时模型只对变化的单元格发出 dataChanged，代理项不会被重建
+            model: cellGrid.showLabels ? cellGrid.cellModel : null
+
+            delegate: Rectangle {
+                id: cell
+                x: model.cellX * cellGrid.cellSize
+                y: model.cellY * cellGrid.cellSize
+                width: cellGrid.cellSize
+                height: cellGrid.cellSize
+                color: "transparent"
+                border.color: "#bdc3c7"
+                border.width: 0.5
+                radius: 2
+
+                property bool isEndpoint: (model.cellX === pathfinder.start.x && model.cellY === pathfinder.start.y) ||
+                                          (model.cellX === pathfinder.end.x && model.cellY === pathfinder.end.y)
+                property int cellFlags: model.cellFlags
+                property int cellValue: model[cellGrid.valueRole]
+
+                Text {
+                    anchors.centerIn: parent
+                    text: {
+                        if (cell.cellFlags & Pathfinder.CellObstacle) return "█";
+                        else if ((cell.cellFlags & Pathfinder.CellOpen) || (cell.cellFlags & Pathfinder.CellClosed)) {
+                            return cell.cellValue > 0 && cell.cellValue < 0xFFFF ? cell.cellValue : "";
+                        }
+                        return "";
+                    }
+                    font.pixelSize: Math.min(cell.width, cell.height) * 0.4
+                    color: "white"
+                    font.bold: true
+                    visible: !cell.isEndpoint
+                }
+            }
+        }
+
+        // 悬停高亮只用一个矩形跟随鼠标，不依赖单元格代理项
+        Rectangle {
+            visible: cellMouseArea.containsMouse
+            x: cellMouseArea.hoverX * cellGrid.cellSize
+            y: cellMouseArea.hoverY * cellGrid.cellSize
+            width: cellGrid.cellSize
+            height: cellGrid.cellSize
+            color: "transparent"
+            border.color: "#e74c3c"
+            border.width: 2
+            radius: 2
+        }
+
+        MouseArea {
+            id: cellMouseArea
+            anchors.fill: parent
+            hoverEnabled: true
+
+            property int hoverX: Math.floor(mouseX / cellGrid.cellSize)
+            property int hoverY: Math.floor(mouseY / cellGrid.cellSize)
+
+            onClicked: (mouse) => {
+                var cellX = Math.floor(mouse.x / cellGrid.cellSize)
+                var cellY = Math.floor(mouse.y / cellGrid.cellSize)
+                console.log("=== CELL CLICKED ===")
+                console.log("Cell coordinates: (" + cellX + "," + cellY + ")")
+
+                if (!(cellX === pathfinder.start.x && cellY === pathfinder.start.y) &&
+                    !(cellX === pathfinder.end.x && cellY === pathfinder.end.y)) {
+                    console.log("Calling toggleObstacle...")
+                    pathfinder.toggleObstacle(cellX, cellY);
+                } else {
+                    console.log("Cell is start or end position, skipping toggle")
+                }
+            }
+        }
+    }
+
     component DraggableIcon : Rectangle {
         required property string type // "start" or "end"
         required property point gridPos
@@ -42,8 +124,9 @@ Window {
         property point dragStartPos
         property point startCellPos // 记录拖动开始时的格子位置
         
-        width: gridParent.cellSize * 0.8
-        height: gridParent.cellSize * 0.8
+        // 大网格上单元格只有几个像素，图标保持一个最小尺寸
+        width: Math.max(gridParent.cellSize * 0.8, 12)
+        height: Math.max(gridParent.cellSize * 0.8, 12)
         radius: width / 2
         color: type === "start" ? "#f39c12" : "#e74c3c"
         border.color: "white"
@@ -198,7 +281,7 @@ Window {
                     }
                     
                     Text {
-                        text: "Compare Dijkstra/BFS, Greedy Best-First, and A* Algorithms"
+                        text: "Compare Dijkstra/BFS, Greedy Best-First, A* and Jump Point Search"
                         font.pixelSize: 14
                         color: "#7f8c8d"
                     }
@@ -294,12 +377,12 @@ Window {
 
             // Dijkstra 网格部分 - 修改为正方形容器
             ColumnLayout {
-                Layout.preferredWidth: (parent.width - 32) / 3
+                Layout.preferredWidth: (parent.width - 48) / 4
                 Layout.fillHeight: true
                 spacing: 8
 
                 Text {
-                    text: "Dijkstra/BFS (G cost)"
+                    text: pathfinder.bidirectionalMode ? "Bidirectional Dijkstra (G cost)" : "Dijkstra/BFS (G cost)"
                     font.bold: true
                     horizontalAlignment: Text.AlignHCenter
                     Layout.fillWidth: true
@@ -330,88 +413,10 @@ Window {
                         anchors.fill: parent
                         anchors.margins: 12
 
-                        Grid {
+                        CellGrid {
                             id: dijkstraGrid
-                            anchors.centerIn: parent
-                            rows: pathfinder.gridSize
-                            columns: pathfinder.gridSize
-                            // 关键修改：确保网格本身是正方形
-                            property real cellSize: Math.min(parent.width, parent.height) / pathfinder.gridSize
-                            width: cellSize * pathfinder.gridSize
-                            height: cellSize * pathfinder.gridSize
-
-                            Repeater {
-                                id: dijkstraGridRepeater
-                                model: pathfinder.gridSize * pathfinder.gridSize
-                                
-                                delegate: Rectangle {
-                                    id: dijkstraCell
-                                    width: dijkstraGrid.cellSize
-                                    height: dijkstraGrid.cellSize
-                                    border.color: "#bdc3c7"
-                                    border.width: 0.5
-                                    radius: 2
-
-                                    property int cellX: index % pathfinder.gridSize
-                                    property int cellY: Math.floor(index / pathfinder.gridSize)
-                                    
-                                    property var cellData: pathfinder.getDijkstraCell(cellX, cellY)
-
-                                    color: {
-                                        if (cellX === pathfinder.start.x && cellY === pathfinder.start.y) return "transparent";
-                                        else if (cellX === pathfinder.end.x && cellY === pathfinder.end.y) return "transparent";
-                                        else if (cellData.isObstacle) return "#34495e";
-                                        else if (cellData.isFinalPath) return "#27ae60";
-                                        else if (cellData.isClosed) return "#9b59b6";
-                                        else if (cellData.isOpen) return "#3498db";
-                                        else return "#ecf0f1";
-                                    }
-
-                                    MouseArea {
-                                        anchors.fill: parent
-                                        hoverEnabled: true
-                                        
-                                        onEntered: {
-                                            dijkstraCell.border.width = 2
-                                            dijkstraCell.border.color = "#e74c3c"
-                                        }
-                                        
-                                        onExited: {
-                                            dijkstraCell.border.width = 0.5
-                                            dijkstraCell.border.color = "#bdc3c7"
-                                        }
-                                        
-                                        onClicked: {
-                                            console.log("=== DIJKSTRA CELL CLICKED ===")
-                                            console.log("Cell coordinates: (" + cellX + "," + cellY + ")")
-                                            
-                                            if (!(cellX === pathfinder.start.x && cellY === pathfinder.start.y) &&
-                                                !(cellX === pathfinder.end.x && cellY === pathfinder.end.y)) {
-                                                console.log("Calling toggleObstacle...")
-                                                pathfinder.toggleObstacle(cellX, cellY);
-                                            } else {
-                                                console.log("Cell is start or end position, skipping toggle")
-                                            }
-                                        }
-                                    }
-
-                                    Text {
-                                        anchors.centerIn: parent
-                                        text: {
-                                            if (cellData.isObstacle) return "█";
-                                            else if (cellData.isOpen || cellData.isClosed) {
-                                                return cellData.g > 0 && cellData.g < 999 ? cellData.g : "";
-                                            }
-                                            return "";
-                                        }
-                                        font.pixelSize: Math.min(dijkstraCell.width, dijkstraCell.height) * 0.4
-                                        color: "white"
-                                        font.bold: true
-                                        visible: !(cellX === pathfinder.start.x && cellY === pathfinder.start.y) && 
-                                                !(cellX === pathfinder.end.x && cellY === pathfinder.end.y)
-                                    }
-                                }
-                            }
+                            cellModel: pathfinder.dijkstraModel
+                            valueRole: "g"
                         }
 
                         // 起点图标
@@ -435,7 +440,7 @@ Window {
 
             // Greedy 网格部分 - 修改为正方形容器
             ColumnLayout {
-                Layout.preferredWidth: (parent.width - 32) / 3
+                Layout.preferredWidth: (parent.width - 48) / 4
                 Layout.fillHeight: true
                 spacing: 8
 
@@ -471,88 +476,10 @@ Window {
                         anchors.fill: parent
                         anchors.margins: 12
 
-                        Grid {
+                        CellGrid {
                             id: greedyGrid
-                            anchors.centerIn: parent
-                            rows: pathfinder.gridSize
-                            columns: pathfinder.gridSize
-                            // 关键修改：确保网格本身是正方形
-                            property real cellSize: Math.min(parent.width, parent.height) / pathfinder.gridSize
-                            width: cellSize * pathfinder.gridSize
-                            height: cellSize * pathfinder.gridSize
-
-                            Repeater {
-                                id: greedyGridRepeater
-                                model: pathfinder.gridSize * pathfinder.gridSize
-                                
-                                delegate: Rectangle {
-                                    id: greedyCell
-                                    width: greedyGrid.cellSize
-                                    height: greedyGrid.cellSize
-                                    border.color: "#bdc3c7"
-                                    border.width: 0.5
-                                    radius: 2
-
-                                    property int cellX: index % pathfinder.gridSize
-                                    property int cellY: Math.floor(index / pathfinder.gridSize)
-                                    
-                                    property var cellData: pathfinder.getGreedyCell(cellX, cellY)
-
-                                    color: {
-                                        if (cellX === pathfinder.start.x && cellY === pathfinder.start.y) return "transparent";
-                                        else if (cellX === pathfinder.end.x && cellY === pathfinder.end.y) return "transparent";
-                                        else if (cellData.isObstacle) return "#34495e";
-                                        else if (cellData.isFinalPath) return "#27ae60";
-                                        else if (cellData.isClosed) return "#9b59b6";
-                                        else if (cellData.isOpen) return "#3498db";
-                                        else return "#ecf0f1";
-                                    }
-
-                                    MouseArea {
-                                        anchors.fill: parent
-                                        hoverEnabled: true
-                                        
-                                        onEntered: {
-                                            greedyCell.border.width = 2
-                                            greedyCell.border.color = "#e74c3c"
-                                        }
-                                        
-                                        onExited: {
-                                            greedyCell.border.width = 0.5
-                                            greedyCell.border.color = "#bdc3c7"
-                                        }
-                                        
-                                        onClicked: {
-                                            console.log("=== GREEDY CELL CLICKED ===")
-                                            console.log("Cell coordinates: (" + cellX + "," + cellY + ")")
-                                            
-                                            if (!(cellX === pathfinder.start.x && cellY === pathfinder.start.y) &&
-                                                !(cellX === pathfinder.end.x && cellY === pathfinder.end.y)) {
-                                                console.log("Calling toggleObstacle...")
-                                                pathfinder.toggleObstacle(cellX, cellY);
-                                            } else {
-                                                console.log("Cell is start or end position, skipping toggle")
-                                            }
-                                        }
-                                    }
-
-                                    Text {
-                                        anchors.centerIn: parent
-                                        text: {
-                                            if (cellData.isObstacle) return "█";
-                                            else if (cellData.isOpen || cellData.isClosed) {
-                                                return cellData.h > 0 ? cellData.h : "";
-                                            }
-                                            return "";
-                                        }
-                                        font.pixelSize: Math.min(greedyCell.width, greedyCell.height) * 0.4
-                                        color: "white"
-                                        font.bold: true
-                                        visible: !(cellX === pathfinder.start.x && cellY === pathfinder.start.y) && 
-                                                !(cellX === pathfinder.end.x && cellY === pathfinder.end.y)
-                                    }
-                                }
-                            }
+                            cellModel: pathfinder.greedyModel
+                            valueRole: "h"
                         }
 
                         // 起点图标
@@ -576,12 +503,14 @@ Window {
 
             // A* 网格部分 - 修改为正方形容器
             ColumnLayout {
-                Layout.preferredWidth: (parent.width - 32) / 3
+                Layout.preferredWidth: (parent.width - 48) / 4
                 Layout.fillHeight: true
                 spacing: 8
 
                 Text {
-                    text: "A* (F cost)"
+                    text: pathfinder.bidirectionalMode ? "Bidirectional A* (F cost)"
+                          : (pathfinder.heuristicWeight > 1 ? `Weighted A* (ε = ${pathfinder.heuristicWeight.toFixed(1)})` : "A* (F cost)")
+                            + (pathfinder.landmarkMode ? " + ALT" : "")
                     font.bold: true
                     horizontalAlignment: Text.AlignHCenter
                     Layout.fillWidth: true
@@ -612,88 +541,10 @@ Window {
                         anchors.fill: parent
                         anchors.margins: 12
 
-                        Grid {
+                        CellGrid {
                             id: aStarGrid
-                            anchors.centerIn: parent
-                            rows: pathfinder.gridSize
-                            columns: pathfinder.gridSize
-                            // 关键修改：确保网格本身是正方形
-                            property real cellSize: Math.min(parent.width, parent.height) / pathfinder.gridSize
-                            width: cellSize * pathfinder.gridSize
-                            height: cellSize * pathfinder.gridSize
-
-                            Repeater {
-                                id: aStarGridRepeater
-                                model: pathfinder.gridSize * pathfinder.gridSize
-                                
-                                delegate: Rectangle {
-                                    id: aStarCell
-                                    width: aStarGrid.cellSize
-                                    height: aStarGrid.cellSize
-                                    border.color: "#bdc3c7"
-                                    border.width: 0.5
-                                    radius: 2
-
-                                    property int cellX: index % pathfinder.gridSize
-                                    property int cellY: Math.floor(index / pathfinder.gridSize)
-                                    
-                                    property var cellData: pathfinder.getAStarCell(cellX, cellY)
-
-                                    color: {
-                                        if (cellX === pathfinder.start.x && cellY === pathfinder.start.y) return "transparent";
-                                        else if (cellX === pathfinder.end.x && cellY === pathfinder.end.y) return "transparent";
-                                        else if (cellData.isObstacle) return "#34495e";
-                                        else if (cellData.isFinalPath) return "#27ae60";
-                                        else if (cellData.isClosed) return "#9b59b6";
-                                        else if (cellData.isOpen) return "#3498db";
-                                        else return "#ecf0f1";
-                                    }
-
-                                    MouseArea {
-                                        anchors.fill: parent
-                                        hoverEnabled: true
-                                        
-                                        onEntered: {
-                                            aStarCell.border.width = 2
-                                            aStarCell.border.color = "#e74c3c"
-                                        }
-                                        
-                                        onExited: {
-                                            aStarCell.border.width = 0.5
-                                            aStarCell.border.color = "#bdc3c7"
-                                        }
-                                        
-                                        onClicked: {
-                                            console.log("=== A* CELL CLICKED ===")
-                                            console.log("Cell coordinates: (" + cellX + "," + cellY + ")")
-                                            
-                                            if (!(cellX === pathfinder.start.x && cellY === pathfinder.start.y) &&
-                                                !(cellX === pathfinder.end.x && cellY === pathfinder.end.y)) {
-                                                console.log("Calling toggleObstacle...")
-                                                pathfinder.toggleObstacle(cellX, cellY);
-                                            } else {
-                                                console.log("Cell is start or end position, skipping toggle")
-                                            }
-                                        }
-                                    }
-
-                                    Text {
-                                        anchors.centerIn: parent
-                                        text: {
-                                            if (cellData.isObstacle) return "█";
-                                            else if (cellData.isOpen || cellData.isClosed) {
-                                                return cellData.f > 0 && cellData.f < 999 ? cellData.f : "";
-                                            }
-                                            return "";
-                                        }
-                                        font.pixelSize: Math.min(aStarCell.width, aStarCell.height) * 0.4
-                                        color: "white"
-                                        font.bold: true
-                                        visible: !(cellX === pathfinder.start.x && cellY === pathfinder.start.y) && 
-                                                !(cellX === pathfinder.end.x && cellY === pathfinder.end.y)
-                                    }
-                                }
-                            }
+                            cellModel: pathfinder.aStarModel
+                            valueRole: "f"
                         }
 
                         // 起点图标
@@ -714,6 +565,69 @@ Window {
                     }
                 }
             }
+
+            // JPS 网格部分 - 修改为正方形容器
+            ColumnLayout {
+                Layout.preferredWidth: (parent.width - 48) / 4
+                Layout.fillHeight: true
+                spacing: 8
+
+                Text {
+                    text: "Jump Point Search (F cost)"
+                    font.bold: true
+                    horizontalAlignment: Text.AlignHCenter
+                    Layout.fillWidth: true
+                    color: "#2c3e50"
+                    font.pixelSize: 16
+                }
+
+                Rectangle {
+                    Layout.fillWidth: true
+                    // 关键修改：设置固定的宽高比，确保正方形
+                    Layout.preferredHeight: parent.width
+                    border.color: "#34495e"
+                    border.width: 2
+                    radius: 8
+                    color: "transparent"
+                    
+                    // 简单的阴影效果
+                    Rectangle {
+                        anchors.fill: parent
+                        anchors.topMargin: 2
+                        radius: parent.radius
+                        color: "#20000000"
+                        z: -1
+                    }
+
+                    Item {
+                        id: jumpPointGridContainer
+                        anchors.fill: parent
+                        anchors.margins: 12
+
+                        CellGrid {
+                            id: jumpPointGrid
+                            cellModel: pathfinder.jumpPointModel
+                            valueRole: "f"
+                        }
+
+                        // 起点图标
+                        DraggableIcon {
+                            id: jumpPointStartIcon
+                            type: "start"
+                            gridPos: pathfinder.start
+                            gridParent: jumpPointGrid
+                        }
+
+                        // 终点图标
+                        DraggableIcon {
+                            id: jumpPointEndIcon
+                            type: "end"
+                            gridPos: pathfinder.end
+                            gridParent: jumpPointGrid
+                        }
+                    }
+                }
+            }
         }
 
         // 进度控制区域
@@ -740,7 +654,16 @@ Window {
                 spacing: 12
 
                 Text {
-                    text: `Step ${pathfinder.progress} of ${pathfinder.maxProgress}`
+                    text: `Step ${pathfinder.progress} of ${pathfinder.maxProgress}` + (pathfinder.isComputing ? "  (computing...)" : "")
+                          + (pathfinder.incrementalMode
+                             ? `  •  Incremental: ${pathfinder.incrementalPath.length > 0 ? "path " + (pathfinder.incrementalPath.length - 1) : "no path"}, ${pathfinder.incrementalExpanded} expanded`
+                             : "")
+                          + (pathfinder.hierarchicalMode
+                             ? `  •  Hierarchical: ${pathfinder.hierarchicalPath.length > 0 ? "path " + (pathfinder.hierarchicalPath.length - 1) : "no path"}, ${pathfinder.hierarchicalExpanded} expanded`
+                             : "")
+                          + (pathfinder.anytimeMode
+                             ? `  •  Anytime: ${pathfinder.anytimePath.length > 0 ? "path " + (pathfinder.anytimePath.length - 1) + ", bound " + pathfinder.anytimeBound.toFixed(2) : "no path"}, ${pathfinder.anytimeExpanded} expanded`
+                             : "")
                     font.bold: true
                     color: "#2c3e50"
                     Layout.alignment: Qt.AlignHCenter
@@ -838,11 +761,91 @@ Window {
                         backgroundColor: "#e67e22"
                     }
 
+                    ControlButton {
+                        text: pathfinder.incrementalMode ? "⚡ Incremental On" : "⚡ Incremental Off"
+                        onClicked: pathfinder.incrementalMode = !pathfinder.incrementalMode
+                        backgroundColor: pathfinder.incrementalMode ? "#16a085" : "#7f8c8d"
+                    }
+
+                    ControlButton {
+                        text: pathfinder.hierarchicalMode ? "🧩 Hierarchical On" : "🧩 Hierarchical Off"
+                        onClicked: pathfinder.hierarchicalMode = !pathfinder.hierarchicalMode
+                        backgroundColor: pathfinder.hierarchicalMode ? "#16a085" : "#7f8c8d"
+                    }
+
+                    ControlButton {
+                        text: pathfinder.bidirectionalMode ? "⇄ Bidirectional On" : "⇄ Bidirectional Off"
+                        onClicked: pathfinder.bidirectionalMode = !pathfinder.bidirectionalMode
+                        backgroundColor: pathfinder.bidirectionalMode ? "#16a085" : "#7f8c8d"
+                    }
+
+                    ControlButton {
+                        text: pathfinder.landmarkMode ? "📍 Landmarks On" : "📍 Landmarks Off"
+                        onClicked: pathfinder.landmarkMode = !pathfinder.landmarkMode
+                        backgroundColor: pathfinder.landmarkMode ? "#16a085" : "#7f8c8d"
+                    }
+
+                    ControlButton {
+                        text: pathfinder.anytimeMode ? "⏱ Anytime On" : "⏱ Anytime Off"
+                        onClicked: pathfinder.anytimeMode = !pathfinder.anytimeMode
+                        backgroundColor: pathfinder.anytimeMode ? "#16a085" : "#7f8c8d"
+                    }
+
+                    ControlButton {
+                        text: "📂 Open Map"
+                        onClicked: openMapDialog.open()
+                        backgroundColor: "#2980b9"
+                    }
+
+                    ControlButton {
+                        text: "💾 Save Map"
+                        onClicked: saveMapDialog.open()
+                        backgroundColor: "#2980b9"
+                    }
+
                     ControlButton {
                         text: "🔄 Reset"
                         onClicked: pathfinder.resetSimulation()
                         backgroundColor: "#f39c12"
                     }
+
+                    Text {
+                        text: "Grid"
+                        font.bold: true
+                        color: "#2c3e50"
+                        font.pixelSize: 14
+                    }
+
+                    // 纹理渲染后网格尺寸不再受 QML 单元格数量限制
+                    SpinBox {
+                        from: 5
+                        to: 2000
+                        value: pathfinder.gridSize
+                        editable: true
+                        onValueModified: pathfinder.gridSize = value
+                    }
+
+                    Text {
+                        text: `ε ${pathfinder.heuristicWeight.toFixed(1)}`
+                        font.bold: true
+                        color: "#2c3e50"
+                        font.pixelSize: 14
+                    }
+
+                    // A* 面板的启发权重，松开滑块后才重新计算
+                    Slider {
+                        Layout.preferredWidth: 120
+                        from: 1
+                        to: 5
+                        stepSize: 0.1
+                        snapMode: Slider.SnapAlways
+                        value: pathfinder.heuristicWeight
+                        onPressedChanged: {
+                            if (!pressed) {
+                                pathfinder.heuristicWeight = value
+                            }
+                        }
+                    }
                 }
             }
         }
@@ -901,4 +904,47 @@ Window {
             verticalAlignment: Text.AlignVCenter
         }
     }
+
+    // 二进制地图（.gmap）内存映射打开；MovingAI 的 .map 按文本解析
+    FileDialog {
+        id: openMapDialog
+        title: "Open Map"
+        nameFilters: ["Map files (*.gmap *.map)", "All files (*)"]
+        onAccepted: {
+            if (!pathfinder.loadMap(selectedFile)) {
+                mapErrorText.text = "⚠️ Could not open " + selectedFile
+                mapErrorTimer.restart()
+            }
+        }
+    }
+
+    FileDialog {
+        id: saveMapDialog
+        title: "Save Map"
+        fileMode: FileDialog.SaveFile
+        defaultSuffix: "gmap"
+        nameFilters: ["Binary map (*.gmap)"]
+        onAccepted: {
+            if (!pathfinder.saveMap(selectedFile)) {
+                mapErrorText.text = "⚠️ Could not save " + selectedFile
+                mapErrorTimer.restart()
+            }
+        }
+    }
+
+    Text {
+        id: mapErrorText
+        anchors.bottom: parent.bottom
+        anchors.horizontalCenter: parent.horizontalCenter
+        anchors.bottomMargin: 8
+        visible: mapErrorTimer.running
+        color: "#c0392b"
+        font.pixelSize: 13
+        font.bold: true
+    }
+
+    Timer {
+        id: mapErrorTimer
+        interval: 4000
+    }
 }
\ No newline at end of file
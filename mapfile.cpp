@@ -0,0 +1,162 @@
+#include "mapfile.h"
+#include "mappedfile.h"
+#include <algorithm>
+#include <climits>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+
+namespace {
+
+const char kMagic[8] = { 'A', 'S', 'T', 'A', 'R', 'M', 'A', 'P' };
+const uint32_t kVersion = 1;
+const uint32_t kHasCosts = 0x1;
+const uint64_t kAlignment = 64;
+
+// 文件头，固定 64 字节；各段偏移从文件开头算起
+struct Header {
+    char magic[8];
+    uint32_t version;
+    uint32_t flags;
+    int32_t width;
+    int32_t height;
+    uint32_t maxCost;
+    uint32_t reserved;
+    uint64_t rowOffset;
+    uint64_t columnOffset;
+    uint64_t costOffset;
+    uint64_t fileSize;
+};
+static_assert(sizeof(Header) == 64, "map file header must stay 64 bytes");
+
+uint64_t alignUp(uint64_t value) {
+    return (value + kAlignment - 1) / kAlignment * kAlignment;
+}
+
+// [offset, offset + size) 完整落在长为 fileSize 的文件内；先比较偏移，相加不会溢出
+bool fitsInFile(uint64_t offset, uint64_t size, uint64_t fileSize) {
+    return offset <= fileSize && size <= fileSize - offset;
+}
+
+// 代价层的每个值都在 [1, maxCost] 内：代价 0 会造出零代价的边，破坏 ALT 表和桶队列的前提
+bool costsInRange(const uint8_t *costs, uint64_t cells, uint32_t maxCost) {
+    if (maxCost < 1 || maxCost > uint32_t(GridMap::MaxCellCost)) {
+        return false;
+    }
+    uint8_t lowest = UINT8_MAX;
+    uint8_t highest = 0;
+    for (uint64_t index = 0; index < cells; ++index) {
+        lowest = std::min(lowest, costs[index]);
+        highest = std::max(highest, costs[index]);
+    }
+    return lowest >= 1 && highest <= maxCost;
+}
+
+void setError(std::string *error, const std::string &message) {
+    if (error) {
+        *error = message;
+    }
+}
+
+// 顺序写出一段：先补零到 offset（段之间的对齐空隙），再写数据；不依赖 fseek 的 long 偏移
+bool writeSegment(FILE *file, uint64_t &position, uint64_t offset, const void *data, size_t size) {
+    static const char zeros[kAlignment] = {};
+    while (position < offset) {
+        size_t padding = size_t(std::min<uint64_t>(offset - position, kAlignment));
+        if (std::fwrite(zeros, 1, padding, file) != padding) {
+            return false;
+        }
+        position += padding;
+    }
+    position += size;
+    return std::fwrite(data, 1, size, file) == size;
+}
+
+}
+
+namespace MapFile {
+
+bool save(const GridMap &map, const std::string &path, std::string *error) {
+    uint64_t bitBytes = GridMap::bitWordCount(map.width(), map.height()) * sizeof(uint64_t);
+
+    Header header = {};
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kVersion;
+    header.flags = map.hasCosts() ? kHasCosts : 0;
+    header.width = map.width();
+    header.height = map.height();
+    header.maxCost = uint32_t(map.maxCost());
+    header.rowOffset = alignUp(sizeof(Header));
+    header.columnOffset = alignUp(header.rowOffset + bitBytes);
+    header.costOffset = map.hasCosts() ? alignUp(header.columnOffset + bitBytes) : 0;
+    header.fileSize = map.hasCosts() ? header.costOffset + uint64_t(map.cellCount()) : header.columnOffset + bitBytes;
+
+    FILE *file = std::fopen(path.c_str(), "wb");
+    if (!file) {
+        setError(error, "cannot create " + path);
+        return false;
+    }
+    uint64_t position = 0;
+    bool ok = writeSegment(file, position, 0, &header, sizeof(header))
+           && writeSegment(file, position, header.rowOffset, map.rowWords(), size_t(bitBytes))
+           && writeSegment(file, position, header.columnOffset, map.columnWords(), size_t(bitBytes))
+           && (!map.hasCosts() || writeSegment(file, position, header.costOffset, map.costBytes(), size_t(map.cellCount())));
+    ok = std::fclose(file) == 0 && ok;
+    if (!ok) {
+        setError(error, "cannot write " + path);
+    }
+    return ok;
+}
+
+bool open(const std::string &path, GridMap &map, std::string *error) {
+    auto file = std::make_shared<MappedFile>();
+    if (!file->open(path)) {
+        setError(error, "cannot map " + path);
+        return false;
+    }
+    if (file->size() < sizeof(Header)) {
+        setError(error, path + " is too small to be a map file");
+        return false;
+    }
+
+    Header header;
+    std::memcpy(&header, file->data(), sizeof(header));
+    if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0 || header.version != kVersion) {
+        setError(error, path + " is not a map file of a supported version");
+        return false;
+    }
+
+    // 尺寸相乘不得溢出单元格索引的 int，各段必须对齐并完整落在文件内
+    uint64_t cells = uint64_t(uint32_t(header.width)) * uint32_t(header.height);
+    if (header.width <= 0 || header.height <= 0 || cells > uint64_t(INT_MAX)) {
+        setError(error, path + " has invalid dimensions");
+        return false;
+    }
+    uint64_t bitBytes = GridMap::bitWordCount(header.width, header.height) * sizeof(uint64_t);
+    bool hasCosts = header.flags & kHasCosts;
+    bool valid = header.rowOffset % kAlignment == 0 && header.columnOffset % kAlignment == 0
+              && header.rowOffset >= sizeof(Header)
+              && fitsInFile(header.rowOffset, bitBytes, file->size())
+              && fitsInFile(header.columnOffset, bitBytes, file->size())
+              && (!hasCosts || fitsInFile(header.costOffset, cells, file->size()));
+    if (!valid) {
+        setError(error, path + " is truncated or corrupt");
+        return false;
+    }
+
+    // 代价层要逐字节检查一遍，带代价层的地图打开时会读入整段代价
+    const char *base = file->data();
+    if (hasCosts && !costsInRange(reinterpret_cast<const uint8_t *>(base + header.costOffset), cells, header.maxCost)) {
+        setError(error, path + " has cell costs outside its cost range");
+        return false;
+    }
+
+    map = GridMap::fromExternal(header.width, header.height,
+                                reinterpret_cast<const uint64_t *>(base + header.rowOffset),
+                                reinterpret_cast<const uint64_t *>(base + header.columnOffset),
+                                hasCosts ? reinterpret_cast<const uint8_t *>(base + header.costOffset) : nullptr,
+                                int(header.maxCost), file);
+    return true;
+}
+
+}
@@ -0,0 +1,25 @@
+#ifndef MAPFILE_H
+#define MAPFILE_H
+
+#include "gridmap.h"
+#include <string>
+
+// 二进制地图文件（.gmap）：定长文件头之后依次是行位板、列位板和可选的代价层，
+// 与 GridMap 的内存布局逐字节相同，各段按 64 字节对齐。
+// 打开时只读映射整个文件，GridMap 直接引用映射的内存，不复制数据。障碍物位板不读取，
+// 数 GB 的地图也能在毫秒内打开，实际访问到的页面才由操作系统按需调入；
+// 代价层在打开时扫描一遍，拒绝 0 和超过文件头所记最大值的代价，耗时与格子数成正比。
+// 文件按小端序存放，只能在小端机器上映射。
+namespace MapFile {
+
+constexpr char Extension[] = ".gmap";
+
+// 写出地图；失败时返回 false，并在 error 不为空时写入原因
+bool save(const GridMap &map, const std::string &path, std::string *error = nullptr);
+
+// 映射打开地图文件；失败时返回 false，map 保持不变
+bool open(const std::string &path, GridMap &map, std::string *error = nullptr);
+
+}
+
+#endif // MAPFILE_H
@@ -0,0 +1,32 @@
+#ifndef MAPPEDFILE_H
+#define MAPPEDFILE_H
+
+#include <cstddef>
+#include <string>
+
+// 只读映射整个文件，析构时解除映射。地图文件和地标距离表等预计算数据都用它按需调页，
+// 通常放在 shared_ptr 里，作为引用这块内存的对象的 owner
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile();
+
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    // 空文件也视为失败
+    bool open(const std::string &path);
+
+    const char *data() const { return m_data; }
+    size_t size() const { return m_size; }
+
+private:
+    const char *m_data = nullptr;
+    size_t m_size = 0;
+#ifdef _WIN32
+    void *m_file = nullptr;      // HANDLE，不在头文件里引入 windows.h
+    void *m_mapping = nullptr;
+#endif
+};
+
+#endif // MAPPEDFILE_H
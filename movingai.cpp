@@ -0,0 +1,99 @@
+#include "movingai.h"
+#include <climits>
+#include <fstream>
+#include <sstream>
+
+namespace {
+
+void setError(std::string *error, const std::string &message) {
+    if (error) {
+        *error = message;
+    }
+}
+
+bool isPassableTerrain(char terrain) {
+    return terrain == '.' || terrain == 'G' || terrain == 'S';
+}
+
+}
+
+namespace MovingAi {
+
+bool loadMap(const std::string &path, GridMap &map, std::string *error) {
+    std::ifstream in(path);
+    if (!in) {
+        setError(error, "cannot open " + path);
+        return false;
+    }
+
+    // 文件头：type、height、width 各一行（顺序不限），以 "map" 一行结束
+    int width = 0;
+    int height = 0;
+    std::string line;
+    while (std::getline(in, line)) {
+        std::istringstream fields(line);
+        std::string key;
+        fields >> key;
+        if (key == "height") {
+            fields >> height;
+        } else if (key == "width") {
+            fields >> width;
+        } else if (key == "map") {
+            break;
+        }
+    }
+    if (width <= 0 || height <= 0 || (long long)width * height > INT_MAX) {
+        setError(error, path + " has a missing or invalid map header");
+        return false;
+    }
+
+    GridMap loaded(width, height);
+    for (int y = 0; y < height; ++y) {
+        if (!std::getline(in, line) || int(line.size()) < width) {
+            setError(error, path + ": row " + std::to_string(y) + " is missing or too short");
+            return false;
+        }
+        for (int x = 0; x < width; ++x) {
+            if (!isPassableTerrain(line[size_t(x)])) {
+                loaded.setObstacle(x, y, true);
+            }
+        }
+    }
+
+    map = std::move(loaded);
+    return true;
+}
+
+bool loadScenarios(const std::string &path, std::vector<Scenario> &scenarios, std::string *error) {
+    std::ifstream in(path);
+    if (!in) {
+        setError(error, "cannot open " + path);
+        return false;
+    }
+
+    std::string line;
+    std::vector<Scenario> loaded;
+    int lineNumber = 0;
+    while (std::getline(in, line)) {
+        ++lineNumber;
+        if (line.empty() || line.compare(0, 7, "version") == 0) {
+            continue;
+        }
+
+        // bucket  map  宽  高  起点x  起点y  终点x  终点y  最优长度（制表符分隔）
+        std::istringstream fields(line);
+        Scenario scenario;
+        if (!(fields >> scenario.bucket >> scenario.mapName >> scenario.mapWidth >> scenario.mapHeight
+                     >> scenario.start.x >> scenario.start.y >> scenario.goal.x >> scenario.goal.y
+                     >> scenario.optimalLength)) {
+            setError(error, path + ": malformed line " + std::to_string(lineNumber));
+            return false;
+        }
+        loaded.push_back(scenario);
+    }
+
+    scenarios = std::move(loaded);
+    return true;
+}
+
+}
@@ -0,0 +1,31 @@
+#ifndef MOVINGAI_H
+#define MOVINGAI_H
+
+#include "gridmap.h"
+#include <string>
+#include <vector>
+
+// MovingAI 基准集（movingai.com/benchmarks）的 .map 地图与 .scen 场景文件。
+// 地图按行流式解析，直接写进 GridMap，不保留整份文本。
+// '.'、'G'、'S'（沼泽）可走，'@'、'O'、'T'（树）、'W'（水）不可走。
+namespace MovingAi {
+
+// 场景文件的一行：一次查询及其在八邻域（斜行代价 √2）下的最优路径长度
+struct Scenario {
+    int bucket = 0;
+    std::string mapName;
+    int mapWidth = 0;
+    int mapHeight = 0;
+    GridPoint start;
+    GridPoint goal;
+    double optimalLength = 0;
+};
+
+// 失败时返回 false，并在 error 不为空时写入原因；map 只在成功时被替换
+bool loadMap(const std::string &path, GridMap &map, std::string *error = nullptr);
+
+bool loadScenarios(const std::string &path, std::vector<Scenario> &scenarios, std::string *error = nullptr);
+
+}
+
+#endif // MOVINGAI_H
@@ -0,0 +1,61 @@
+#ifndef NEIGHBORHOODS_H
+#define NEIGHBORHOODS_H
+
+#include "gridmap.h"
+
+// 邻域（移动模型）策略：给出可走的方向、每个方向的代价，以及斜向移动经过墙角时的规则。
+// 与启发函数一样作为搜索内核的模板参数，方向循环在编译期展开。
+
+// 斜向移动经过墙角时的规则
+enum class CornerRule {
+    CutCorners,     // 只要斜对角的格子可走就能移动
+    NoSqueeze,      // 两侧的直行格子都被挡住时不能从缝隙中斜穿
+    NoCutCorners    // 任一侧的直行格子被挡住就不能斜穿
+};
+
+// 四邻域：只能上下左右移动，每步代价 1
+struct FourConnected {
+    static constexpr int Id = 0;    // 写进预计算文件（如地标距离表），防止换了邻域还在用旧数据
+    static constexpr bool AllowsDiagonal = false;
+    static constexpr bool ConnectsDiagonally = false;
+    static constexpr int StraightCost = 1;
+    static constexpr int DiagonalCost = 2;   // 相当于两步直行，供八角距离等启发函数使用
+    static constexpr int Count = 4;
+    static constexpr int Offsets[Count][2] = { {-1, 0}, {0, -1}, {0, 1}, {1, 0} };
+
+    static constexpr int cost(int, int) { return StraightCost; }
+
+    // 目标格已确认可走；四邻域没有额外限制
+    static bool canMove(const GridMap &, int, int, int, int) { return true; }
+};
+
+// 八邻域：直行代价 70，斜行代价 99。99/70 略大于 √2，欧氏距离启发因此不会高估
+template <CornerRule Rule = CornerRule::NoCutCorners>
+struct EightConnected {
+    static constexpr int Id = 1 + int(Rule);
+    static constexpr bool AllowsDiagonal = true;
+    // 只有切角规则下斜向移动能连通两个没有直行通路的格子；
+    // NoSqueeze 要求至少一侧的直行格可走，经过那一格同样连通
+    static constexpr bool ConnectsDiagonally = Rule == CornerRule::CutCorners;
+    static constexpr int StraightCost = 70;
+    static constexpr int DiagonalCost = 99;
+    static constexpr int Count = 8;
+    static constexpr int Offsets[Count][2] = {
+        {-1, 0}, {0, -1}, {0, 1}, {1, 0},
+        {-1, -1}, {1, -1}, {-1, 1}, {1, 1}
+    };
+
+    static constexpr int cost(int dx, int dy) { return dx != 0 && dy != 0 ? DiagonalCost : StraightCost; }
+
+    // 目标格已确认可走，这里只检查斜向移动经过的两个直行格子
+    static bool canMove(const GridMap &map, int x, int y, int dx, int dy) {
+        if (dx == 0 || dy == 0 || Rule == CornerRule::CutCorners) {
+            return true;
+        }
+        bool horizontal = map.isPassable(x + dx, y);
+        bool vertical = map.isPassable(x, y + dy);
+        return Rule == CornerRule::NoSqueeze ? (horizontal || vertical) : (horizontal && vertical);
+    }
+};
+
+#endif // NEIGHBORHOODS_H
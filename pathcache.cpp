@@ -0,0 +1,19 @@
+#include "pathcache.h"
+
+size_t PathKeyHash::operator()(const PathKey &key) const {
+    // 地图散列已经是均匀的 64 位值，其余字段逐个乘加混入
+    uint64_t hash = key.mapHash;
+    for (uint64_t field : { uint64_t(uint32_t(key.width)), uint64_t(uint32_t(key.height)),
+                            uint64_t(uint32_t(key.start.x)), uint64_t(uint32_t(key.start.y)),
+                            uint64_t(uint32_t(key.goal.x)), uint64_t(uint32_t(key.goal.y)),
+                            uint64_t(key.algorithm), uint64_t(key.variant) }) {
+        hash = (hash ^ field) * 0x100000001B3ull;
+        hash ^= hash >> 29;
+    }
+    return size_t(hash);
+}
+
+size_t memoryBytes(const PathResult &result) {
+    // 结果本身、路径数组，以及缓存链表和索引里每项的大致开销
+    return sizeof(PathResult) + result.path.capacity() * sizeof(GridPoint) + sizeof(PathKey) + 64;
+}
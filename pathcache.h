@@ -0,0 +1,169 @@
+#ifndef PATHCACHE_H
+#define PATHCACHE_H
+
+#include "pathengine.h"
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+// 一次查询的缓存键：地图内容散列（GridMap::contentHash）、尺寸、起点终点和算法。
+// variant 由调用方区分同一算法的不同设置，例如启发权重或双向搜索
+struct PathKey {
+    uint64_t mapHash = 0;
+    int width = 0;
+    int height = 0;
+    GridPoint start;
+    GridPoint goal;
+    Algorithm algorithm = Algorithm::AStar;
+    uint32_t variant = 0;
+
+    bool operator==(const PathKey &other) const {
+        return mapHash == other.mapHash && width == other.width && height == other.height
+            && start == other.start && goal == other.goal && algorithm == other.algorithm && variant == other.variant;
+    }
+};
+
+struct PathKeyHash {
+    size_t operator()(const PathKey &key) const;
+};
+
+// 按内存预算淘汰最久未用项的结果缓存，可以被多个线程同时使用。
+// 值以 shared_ptr<const Value> 共享，淘汰后仍在使用的调用方不受影响；
+// bytes 由调用方估计，单个值超过整个预算时不缓存
+template <typename Value>
+class LruCache {
+public:
+    explicit LruCache(size_t budgetBytes) : m_budget(budgetBytes) {}
+
+    LruCache(const LruCache &) = delete;
+    LruCache &operator=(const LruCache &) = delete;
+
+    // 命中时把这一项移到最近使用的一端
+    std::shared_ptr<const Value> find(const PathKey &key);
+    void insert(const PathKey &key, std::shared_ptr<const Value> value, size_t bytes);
+    void clear();
+
+    // 缩小预算时立即淘汰
+    void setBudget(size_t budgetBytes);
+    size_t budget() const;
+
+    size_t size() const;
+    size_t bytes() const;
+    long long hits() const;
+    long long misses() const;
+
+private:
+    struct Entry {
+        PathKey key;
+        std::shared_ptr<const Value> value;
+        size_t bytes;
+    };
+
+    void evictTo(size_t budgetBytes);
+
+    mutable std::mutex m_mutex;
+    std::list<Entry> m_entries;   // 最近使用的在前
+    std::unordered_map<PathKey, typename std::list<Entry>::iterator, PathKeyHash> m_index;
+    size_t m_budget;
+    size_t m_bytes = 0;
+    long long m_hits = 0;
+    long long m_misses = 0;
+};
+
+// 缓存 findPath 的结果，供批量接口等后台调用方使用
+using PathCache = LruCache<PathResult>;
+
+// PathResult 占用内存的估计值，作为 PathCache::insert 的 bytes
+size_t memoryBytes(const PathResult &result);
+
+template <typename Value>
+std::shared_ptr<const Value> LruCache<Value>::find(const PathKey &key) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto found = m_index.find(key);
+    if (found == m_index.end()) {
+        ++m_misses;
+        return nullptr;
+    }
+    ++m_hits;
+    m_entries.splice(m_entries.begin(), m_entries, found->second);
+    return found->second->value;
+}
+
+template <typename Value>
+void LruCache<Value>::insert(const PathKey &key, std::shared_ptr<const Value> value, size_t bytes) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto found = m_index.find(key);
+    if (found != m_index.end()) {
+        m_bytes -= found->second->bytes;
+        m_entries.erase(found->second);
+        m_index.erase(found);
+    }
+    if (bytes > m_budget) {
+        return;
+    }
+
+    evictTo(m_budget - bytes);
+    m_entries.push_front({key, std::move(value), bytes});
+    m_index.emplace(key, m_entries.begin());
+    m_bytes += bytes;
+}
+
+template <typename Value>
+void LruCache<Value>::clear() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_entries.clear();
+    m_index.clear();
+    m_bytes = 0;
+}
+
+template <typename Value>
+void LruCache<Value>::setBudget(size_t budgetBytes) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_budget = budgetBytes;
+    evictTo(m_budget);
+}
+
+template <typename Value>
+size_t LruCache<Value>::budget() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_budget;
+}
+
+template <typename Value>
+size_t LruCache<Value>::size() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_entries.size();
+}
+
+template <typename Value>
+size_t LruCache<Value>::bytes() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_bytes;
+}
+
+template <typename Value>
+long long LruCache<Value>::hits() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_hits;
+}
+
+template <typename Value>
+long long LruCache<Value>::misses() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_misses;
+}
+
+template <typename Value>
+void LruCache<Value>::evictTo(size_t budgetBytes) {
+    while (m_bytes > budgetBytes && !m_entries.empty()) {
+        const Entry &oldest = m_entries.back();
+        m_bytes -= oldest.bytes;
+        m_index.erase(oldest.key);
+        m_entries.pop_back();
+    }
+}
+
+#endif // PATHCACHE_H
@@ -0,0 +1,210 @@
+#include "pathdatabase.h"
+#include "mappedfile.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+namespace {
+
+const char kMagic[8] = { 'A', 'S', 'T', 'A', 'R', 'C', 'P', 'D' };
+const uint32_t kVersion = 1;
+const uint64_t kAlignment = 64;
+const int kMoveBits = 4;
+
+// 文件头，固定 64 字节；之后按 64 字节对齐依次放 cellCount + 1 个行偏移（uint64）和所有段（uint32）
+struct Header {
+    char magic[8];
+    uint32_t version;
+    uint32_t neighborhood;
+    int32_t width;
+    int32_t height;
+    uint32_t reserved[2];
+    uint64_t mapHash;
+    uint64_t offsetTableOffset;
+    uint64_t runOffset;
+    uint64_t fileSize;
+};
+static_assert(sizeof(Header) == 64, "path database header must stay 64 bytes");
+
+uint64_t alignUp(uint64_t value) {
+    return (value + kAlignment - 1) / kAlignment * kAlignment;
+}
+
+// 空的区段不调用 fwrite：空 vector 的 data() 可能是空指针
+bool writeBytes(FILE *file, const void *data, size_t size) {
+    return size == 0 || std::fwrite(data, 1, size, file) == size;
+}
+
+// [offset, offset + size) 完整落在长为 fileSize 的文件内；先比较偏移，相加不会溢出
+bool fitsInFile(uint64_t offset, uint64_t size, uint64_t fileSize) {
+    return offset <= fileSize && size <= fileSize - offset;
+}
+
+void setError(std::string *error, const std::string &message) {
+    if (error) {
+        *error = message;
+    }
+}
+
+}
+
+void PathDatabase::beginBuild(const GridMap &map, int neighborhood) {
+    m_width = 0;
+    m_height = 0;
+    m_neighborhood = neighborhood;
+    m_mapHash = map.contentHash();
+    m_ownedOffsets.clear();
+    m_ownedRuns.clear();
+    m_offsets = nullptr;
+    m_runs = nullptr;
+    m_owner.reset();
+    if (map.cellCount() <= MaxCells) {
+        m_width = map.width();
+        m_height = map.height();
+    }
+}
+
+void PathDatabase::compressRow(const GridMap &map, int source, const std::vector<uint8_t> &moves, std::vector<uint32_t> &row) {
+    row.clear();
+    int currentMove = -1;
+    for (int target = 0; target < map.cellCount(); ++target) {
+        // 障碍物和起点自身不会被查询，沿用当前段；行首的通配格归入第一段
+        if (target == source || map.isObstacle(target)) {
+            continue;
+        }
+        int move = moves[target];
+        if (move == currentMove) {
+            continue;
+        }
+        uint32_t first = row.empty() ? 0 : uint32_t(target);
+        row.push_back(first << kMoveBits | uint32_t(move));
+        currentMove = move;
+    }
+    row.shrink_to_fit();
+}
+
+void PathDatabase::finishBuild(std::vector<std::vector<uint32_t>> &rows) {
+    m_ownedOffsets.assign(rows.size() + 1, 0);
+    for (size_t source = 0; source < rows.size(); ++source) {
+        m_ownedOffsets[source + 1] = m_ownedOffsets[source] + rows[source].size();
+    }
+    m_ownedRuns.reserve(size_t(m_ownedOffsets.back()));
+    for (std::vector<uint32_t> &row : rows) {
+        m_ownedRuns.insert(m_ownedRuns.end(), row.begin(), row.end());
+        std::vector<uint32_t>().swap(row);
+    }
+    m_offsets = m_ownedOffsets.data();
+    m_runs = m_ownedRuns.data();
+}
+
+int PathDatabase::firstMove(int source, int target) const {
+    const uint32_t *begin = m_runs + m_offsets[source];
+    const uint32_t *end = m_runs + m_offsets[source + 1];
+    if (begin == end) {
+        return -1;
+    }
+    // 最后一个段首不大于 target 的段；第一段的段首总是 0
+    uint32_t key = uint32_t(target) << kMoveBits | ((1u << kMoveBits) - 1);
+    const uint32_t *run = std::upper_bound(begin, end, key) - 1;
+    int move = int(*run & ((1u << kMoveBits) - 1));
+    return move == NoMove ? -1 : move;
+}
+
+bool PathDatabase::save(const std::string &path, std::string *error) const {
+    // 与地标表一致：没有任何路段（地图上不足两个可走格）的数据库不写出
+    if (isEmpty() || runCount() == 0) {
+        setError(error, "path database is empty");
+        return false;
+    }
+    uint64_t offsetBytes = (uint64_t(m_width) * m_height + 1) * sizeof(uint64_t);
+    uint64_t runBytes = runCount() * sizeof(uint32_t);
+
+    Header header = {};
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kVersion;
+    header.neighborhood = uint32_t(m_neighborhood);
+    header.width = m_width;
+    header.height = m_height;
+    header.mapHash = m_mapHash;
+    header.offsetTableOffset = alignUp(sizeof(Header));
+    header.runOffset = alignUp(header.offsetTableOffset + offsetBytes);
+    header.fileSize = header.runOffset + runBytes;
+
+    FILE *file = std::fopen(path.c_str(), "wb");
+    if (!file) {
+        setError(error, "cannot create " + path);
+        return false;
+    }
+    std::vector<char> padding(size_t(header.runOffset - header.offsetTableOffset - offsetBytes), 0);
+    bool ok = std::fwrite(&header, sizeof(header), 1, file) == 1
+           && writeBytes(file, m_offsets, size_t(offsetBytes))
+           && writeBytes(file, padding.data(), padding.size())
+           && writeBytes(file, m_runs, size_t(runBytes));
+    ok = std::fclose(file) == 0 && ok;
+    if (!ok) {
+        setError(error, "cannot write " + path);
+    }
+    return ok;
+}
+
+bool PathDatabase::openFile(const std::string &path, const GridMap &map, int neighborhood, std::string *error) {
+    auto file = std::make_shared<MappedFile>();
+    if (!file->open(path)) {
+        setError(error, "cannot map " + path);
+        return false;
+    }
+    if (file->size() < sizeof(Header)) {
+        setError(error, path + " is too small to be a path database");
+        return false;
+    }
+
+    Header header;
+    std::memcpy(&header, file->data(), sizeof(header));
+    if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0 || header.version != kVersion) {
+        setError(error, path + " is not a path database of a supported version");
+        return false;
+    }
+    if (header.width != map.width() || header.height != map.height() || header.mapHash != map.contentHash()) {
+        setError(error, path + " was built for a different map");
+        return false;
+    }
+    if (int(header.neighborhood) != neighborhood) {
+        setError(error, path + " was built for a different neighborhood");
+        return false;
+    }
+
+    // 行偏移必须单调，且最后一个不超出文件；逐行检查一遍，之后查表不再做边界检查
+    size_t cells = size_t(map.cellCount());
+    uint64_t offsetBytes = (uint64_t(cells) + 1) * sizeof(uint64_t);
+    bool valid = map.cellCount() <= MaxCells
+              && header.offsetTableOffset % kAlignment == 0 && header.offsetTableOffset >= sizeof(Header)
+              && fitsInFile(header.offsetTableOffset, offsetBytes, file->size())
+              && header.runOffset % kAlignment == 0 && header.runOffset >= header.offsetTableOffset + offsetBytes
+              && header.runOffset <= file->size();
+    const char *base = file->data();
+    const uint64_t *offsets = reinterpret_cast<const uint64_t *>(base + header.offsetTableOffset);
+    if (valid) {
+        uint64_t available = (file->size() - header.runOffset) / sizeof(uint32_t);
+        valid = offsets[0] == 0 && offsets[cells] <= available;
+        for (size_t source = 0; source < cells && valid; ++source) {
+            valid = offsets[source] <= offsets[source + 1];
+        }
+    }
+    if (!valid) {
+        setError(error, path + " is truncated or corrupt");
+        return false;
+    }
+
+    m_width = header.width;
+    m_height = header.height;
+    m_neighborhood = neighborhood;
+    m_mapHash = header.mapHash;
+    m_ownedOffsets.clear();
+    m_ownedOffsets.shrink_to_fit();
+    m_ownedRuns.clear();
+    m_ownedRuns.shrink_to_fit();
+    m_offsets = offsets;
+    m_runs = reinterpret_cast<const uint32_t *>(base + header.runOffset);
+    m_owner = file;
+    return true;
+}
@@ -0,0 +1,190 @@
+#ifndef PATHDATABASE_H
+#define PATHDATABASE_H
+
+#include "gridmap.h"
+#include "indexedheap.h"
+#include "neighborhoods.h"
+#include "pathengine.h"
+#include "workstealingpool.h"
+#include <climits>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+// 压缩路径数据库（Compressed Path Database）：对不再修改的地图，离线为每个起点格记录
+// 走向所有终点格的最优路径的第一步，查询时从起点开始逐步查表，不做任何搜索。
+//
+// 一个起点的一行按单元格索引（与 GridMap 相同的行优先顺序）排列终点，相邻终点的第一步
+// 往往相同，所以按游程压缩：每段记一个 32 位值，高 28 位是这段的第一个终点，低 4 位是
+// 第一步在 Neighborhood::Offsets 中的下标。障碍物和起点自身不会被查询，当作通配，
+// 并入前一段。查第一步是在一行的若干段里二分查找。
+//
+// 构建要从每个可走格跑一遍 Dijkstra，代价与格子数的平方成正比，只适合离线做一次：
+// 用 astar_cpd 生成文件，运行时按内存映射打开。
+class PathDatabase {
+public:
+    static constexpr int NoMove = 0xF;             // 终点不可达
+    static constexpr int MaxCells = 1 << 28;       // 段首的终点索引只有 28 位
+
+    PathDatabase() = default;
+    PathDatabase(const PathDatabase &) = delete;
+    PathDatabase &operator=(const PathDatabase &) = delete;
+
+    // 从每个可走格各跑一遍 Dijkstra，分给 threadCount 个线程（0 表示硬件并发数）。
+    // 地图超过 MaxCells 格时数据库保持为空
+    template <typename Neighborhood = FourConnected>
+    void build(const GridMap &map, int threadCount = 0);
+
+    // 写出数据库；数据库为空（地图上不足两个可走格）或写入失败时返回 false，并在 error 不为空时写入原因
+    bool save(const std::string &path, std::string *error = nullptr) const;
+
+    // 映射打开数据库文件，不复制数据；文件必须由内容相同的地图（按 GridMap::contentHash 比较）
+    // 和同一种邻域构建，否则返回 false，数据库保持不变
+    template <typename Neighborhood = FourConnected>
+    bool open(const std::string &path, const GridMap &map, std::string *error = nullptr) {
+        return openFile(path, map, Neighborhood::Id, error);
+    }
+
+    bool isEmpty() const { return m_width == 0; }
+    bool isMapped() const { return m_owner != nullptr; }
+    int width() const { return m_width; }
+    int height() const { return m_height; }
+    uint64_t runCount() const { return m_offsets ? m_offsets[size_t(m_width) * m_height] : 0; }
+    size_t memoryBytes() const {
+        return isEmpty() ? 0 : (size_t(m_width) * m_height + 1) * sizeof(uint64_t) + size_t(runCount()) * sizeof(uint32_t);
+    }
+
+    // 这个数据库能否用于在 map 上按该邻域查询（尺寸和邻域一致；内容是否一致由调用方保证）
+    template <typename Neighborhood>
+    bool appliesTo(const GridMap &map) const {
+        return !isEmpty() && m_neighborhood == Neighborhood::Id && map.width() == m_width && map.height() == m_height;
+    }
+
+    // 从 source 走向 target 的最优路径第一步在 Offsets 中的下标；不可达、起点是障碍物时返回 -1。
+    // target 必须可走且不等于 source，否则结果没有意义
+    int firstMove(int source, int target) const;
+
+    // 逐步查表取出从 start 到 goal 的一条最优路径，expanded 为 0
+    template <typename Neighborhood = FourConnected>
+    PathResult findPath(const GridMap &map, GridPoint start, GridPoint goal) const;
+
+private:
+    // 每个工作线程的 Dijkstra 暂存数据
+    struct Scratch {
+        std::vector<int> distances;
+        std::vector<uint8_t> moves;
+        IndexedHeap<int> open;
+    };
+
+    // 从 source 出发的 Dijkstra，moves 记录到每格的最优路径从 source 迈出的第一步
+    template <typename Neighborhood>
+    static void firstMovesFrom(const GridMap &map, int source, Scratch &scratch);
+
+    // 以下是与邻域无关的部分，在 pathdatabase.cpp 中实现
+    void beginBuild(const GridMap &map, int neighborhood);
+    static void compressRow(const GridMap &map, int source, const std::vector<uint8_t> &moves, std::vector<uint32_t> &row);
+    void finishBuild(std::vector<std::vector<uint32_t>> &rows);
+    bool openFile(const std::string &path, const GridMap &map, int neighborhood, std::string *error);
+
+    int m_width = 0;
+    int m_height = 0;
+    int m_neighborhood = 0;
+    uint64_t m_mapHash = 0;
+    std::vector<uint64_t> m_ownedOffsets;    // 自己构建时的数据，映射打开时为空
+    std::vector<uint32_t> m_ownedRuns;
+    const uint64_t *m_offsets = nullptr;     // 第 i 行的段在 [m_offsets[i], m_offsets[i + 1])
+    const uint32_t *m_runs = nullptr;
+    std::shared_ptr<const void> m_owner;     // 映射文件的所有者，为空表示数据在 m_owned* 里
+};
+
+template <typename Neighborhood>
+void PathDatabase::build(const GridMap &map, int threadCount) {
+    beginBuild(map, Neighborhood::Id);
+    if (map.cellCount() > MaxCells) {
+        return;
+    }
+
+    WorkStealingPool pool(threadCount);
+    std::vector<Scratch> scratches(size_t(pool.threadCount()));
+    std::vector<std::vector<uint32_t>> rows(size_t(map.cellCount()));
+    // 每个起点一次整图 Dijkstra，耗时相近，按小块分发即可
+    pool.parallelFor(map.cellCount(), 16, [&](int worker, int begin, int end) {
+        Scratch &scratch = scratches[worker];
+        for (int source = begin; source < end; ++source) {
+            if (map.isObstacle(source)) {
+                continue;
+            }
+            firstMovesFrom<Neighborhood>(map, source, scratch);
+            compressRow(map, source, scratch.moves, rows[source]);
+        }
+    });
+    finishBuild(rows);
+}
+
+template <typename Neighborhood>
+void PathDatabase::firstMovesFrom(const GridMap &map, int source, Scratch &scratch) {
+    scratch.distances.assign(size_t(map.cellCount()), INT_MAX);
+    scratch.moves.assign(size_t(map.cellCount()), uint8_t(NoMove));
+    scratch.open.reset(map.cellCount());
+    scratch.distances[source] = 0;
+    scratch.open.push(source, 0);
+
+    while (!scratch.open.empty()) {
+        int current = scratch.open.pop();
+        int x = current % map.width();
+        int y = current / map.width();
+        for (int move = 0; move < Neighborhood::Count; ++move) {
+            int dx = Neighborhood::Offsets[move][0];
+            int dy = Neighborhood::Offsets[move][1];
+            int nx = x + dx;
+            int ny = y + dy;
+            if (!map.isPassable(nx, ny) || !Neighborhood::canMove(map, x, y, dx, dy)) {
+                continue;
+            }
+            int neighbor = map.index(nx, ny);
+            int distance = scratch.distances[current] + Neighborhood::cost(dx, dy) * map.cost(neighbor);
+            // 等长的路径保留先找到的第一步
+            if (distance >= scratch.distances[neighbor]) {
+                continue;
+            }
+            if (scratch.open.contains(neighbor)) {
+                scratch.open.decreaseKey(neighbor, distance);
+            } else {
+                scratch.open.push(neighbor, distance);
+            }
+            scratch.distances[neighbor] = distance;
+            scratch.moves[neighbor] = current == source ? uint8_t(move) : scratch.moves[current];
+        }
+    }
+}
+
+template <typename Neighborhood>
+PathResult PathDatabase::findPath(const GridMap &map, GridPoint start, GridPoint goal) const {
+    PathResult result;
+    if (!map.isPassable(start.x, start.y) || !map.isPassable(goal.x, goal.y)) {
+        return result;
+    }
+
+    int target = map.index(goal.x, goal.y);
+    GridPoint current = start;
+    result.path.push_back(current);
+    while (current != goal) {
+        int move = firstMove(map.index(current.x, current.y), target);
+        // 最优路径不会重复经过同一格；走的步数超过格子数说明数据库与地图不符
+        if (move < 0 || int(result.path.size()) > map.cellCount()) {
+            result.path.clear();
+            result.cost = 0;
+            return result;
+        }
+        int dx = Neighborhood::Offsets[move][0];
+        int dy = Neighborhood::Offsets[move][1];
+        current = { current.x + dx, current.y + dy };
+        result.cost += Neighborhood::cost(dx, dy) * map.cost(current.x, current.y);
+        result.path.push_back(current);
+    }
+    result.found = true;
+    return result;
+}
+
+#endif // PATHDATABASE_H
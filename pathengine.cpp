@@ -0,0 +1,195 @@
+#include "pathengine.h"
+#include <algorithm>
+
+template class BasicSearchContext<>;
+
+void SearchContextBase::setHeuristicWeight(double weight) {
+    m_weightPermille = weight > 1.0 ? int(weight * 1000 + 0.5) : 1000;
+}
+
+int SearchContextBase::reset(const GridMap &map, GridPoint start, GridPoint goal, Algorithm algorithm, int startH) {
+    m_map = &map;
+    m_algorithm = algorithm;
+    m_goal = goal;
+    m_goalIndex = map.contains(goal.x, goal.y) ? map.index(goal.x, goal.y) : -1;
+    m_expanded = 0;
+    if (m_jumpTable && (m_jumpTable->width() != map.width() || m_jumpTable->height() != map.height())) {
+        m_jumpTable = nullptr;
+    }
+
+    if (m_grid.width() != map.width() || m_grid.height() != map.height()) {
+        m_grid = SearchGrid(map.width(), map.height());
+    } else {
+        m_grid.resetSearch();
+    }
+    m_status = Running;
+
+    if (!map.isPassable(start.x, start.y)) {
+        return -1;
+    }
+    int startIndex = map.index(start.x, start.y);
+    m_grid.touch(startIndex);
+    m_grid.g[startIndex] = 0;
+    m_grid.h[startIndex] = startH;
+    m_grid.f[startIndex] = startH;
+    m_grid.flags[startIndex] = SearchGrid::Open;
+    return startIndex;
+}
+
+bool SearchContextBase::rejectUnreachable(const GridMap &map, GridPoint start, GridPoint goal, Algorithm algorithm) {
+    if (m_components->width() != map.width() || m_components->height() != map.height()
+        || m_components->connected(start, goal)) {
+        return false;
+    }
+
+    m_map = &map;
+    m_algorithm = algorithm;
+    m_goal = goal;
+    m_goalIndex = -1;
+    m_expanded = 0;
+    if (m_grid.width() != map.width() || m_grid.height() != map.height()) {
+        m_grid = SearchGrid(map.width(), map.height());
+    }
+    m_status = Exhausted;
+    return true;
+}
+
+std::vector<GridPoint> SearchContextBase::path() const {
+    std::vector<GridPoint> result;
+    path(result);
+    return result;
+}
+
+void SearchContextBase::path(std::vector<GridPoint> &result) const {
+    result.clear();
+    if (m_status != Found) {
+        return;
+    }
+
+    for (int index = m_goalIndex; index != SearchGrid::NoParent; index = m_grid.parent[index]) {
+        int x = m_grid.xOf(index);
+        int y = m_grid.yOf(index);
+        result.push_back({x, y});
+
+        // 跳点之间是一段直线，逐格补齐（普通搜索的父节点总是相邻格，不会进入循环）
+        int parent = m_grid.parent[index];
+        if (parent != SearchGrid::NoParent) {
+            int dx = m_grid.xOf(parent) > x ? 1 : m_grid.xOf(parent) < x ? -1 : 0;
+            int dy = m_grid.yOf(parent) > y ? 1 : m_grid.yOf(parent) < y ? -1 : 0;
+            for (x += dx, y += dy; m_grid.index(x, y) != parent; x += dx, y += dy) {
+                result.push_back({x, y});
+            }
+        }
+    }
+    std::reverse(result.begin(), result.end());
+}
+
+int SearchContextBase::jumpDirections(int index, int directions[4][2]) const {
+    int x = m_grid.xOf(index);
+    int y = m_grid.yOf(index);
+    int parent = m_grid.parent[index];
+    int count = 0;
+
+    if (parent == SearchGrid::NoParent) {
+        // 起点向四个方向都要跳
+        static const int all[4][2] = { {-1, 0}, {0, -1}, {0, 1}, {1, 0} };
+        for (const auto &direction : all) {
+            directions[count][0] = direction[0];
+            directions[count][1] = direction[1];
+            ++count;
+        }
+        return count;
+    }
+
+    int px = m_grid.xOf(parent);
+    int py = m_grid.yOf(parent);
+    int dx = x > px ? 1 : x < px ? -1 : 0;
+    int dy = y > py ? 1 : y < py ? -1 : 0;
+
+    if (dx != 0) {
+        // 水平到达：继续向前，外加被挡住一侧的强制邻居
+        directions[count][0] = dx;
+        directions[count][1] = 0;
+        ++count;
+        for (int side : { -1, 1 }) {
+            if (m_map->isPassable(x, y + side) && !m_map->isPassable(x - dx, y + side)) {
+                directions[count][0] = 0;
+                directions[count][1] = side;
+                ++count;
+            }
+        }
+    } else {
+        // 垂直到达：继续向前，并向左右两侧展开
+        directions[count][0] = 0;
+        directions[count][1] = dy;
+        ++count;
+        for (int side : { -1, 1 }) {
+            directions[count][0] = side;
+            directions[count][1] = 0;
+            ++count;
+        }
+    }
+    return count;
+}
+
+int SearchContextBase::jump(int x, int y, int dx, int dy) const {
+    if (dx != 0) {
+        // 水平跳跃：查表或用行位板扫描，两者的返回值含义相同
+        int distance = m_jumpTable ? m_jumpTable->distance(m_map->index(x, y), JumpTable::directionOf(dx, 0))
+                                   : JumpTable::scanRow(*m_map, x, y, dx);
+        int reach = distance > 0 ? distance : -distance;
+
+        // 表和扫描都与终点无关：终点落在这次跳跃的范围内时要提前停下
+        int steps = (m_goal.x - x) * dx;
+        if (m_goalIndex >= 0 && m_goal.y == y && steps >= 1 && steps <= reach) {
+            return m_goalIndex;
+        }
+        return distance > 0 ? m_map->index(x + dx * distance, y) : -1;
+    }
+
+    if (m_jumpTable) {
+        return tableJumpVertical(x, y, dy);
+    }
+
+    // 垂直跳跃：先用列位板找到墙，再在途经的每一格向左右两侧做行扫描
+    int reach = m_map->freeRunInColumn(x, y, dy);
+    for (int k = 1; k <= reach; ++k) {
+        int cy = y + k * dy;
+        int index = m_map->index(x, cy);
+        if (index == m_goalIndex) {
+            return index;
+        }
+
+        int east = JumpTable::scanRow(*m_map, x, cy, 1);
+        int west = JumpTable::scanRow(*m_map, x, cy, -1);
+        if (east > 0 || west > 0) {
+            return index;
+        }
+
+        // 终点所在行：能水平直达终点时这一格也是跳点
+        if (m_goalIndex >= 0 && cy == m_goal.y && -(m_goal.x > x ? east : west) >= std::abs(m_goal.x - x)) {
+            return index;
+        }
+    }
+    return -1;
+}
+
+int SearchContextBase::tableJumpVertical(int x, int y, int dy) const {
+    int distance = m_jumpTable->distance(m_map->index(x, y), JumpTable::directionOf(0, dy));
+    int reach = distance > 0 ? distance : -distance;
+
+    int steps = (m_goal.y - y) * dy;
+    if (m_goalIndex >= 0 && steps >= 1 && steps <= reach) {
+        // 走到终点所在行时，若能水平直达终点，这一格就是跳点
+        if (m_goal.x == x) {
+            return m_goalIndex;
+        }
+        int cross = m_map->index(x, m_goal.y);
+        int side = m_jumpTable->distance(cross, m_goal.x > x ? JumpTable::East : JumpTable::West);
+        if (side <= 0 && -side >= std::abs(m_goal.x - x)) {
+            return cross;
+        }
+    }
+
+    return distance > 0 ? m_map->index(x, y + dy * distance) : -1;
+}
@@ -0,0 +1,339 @@
+#ifndef PATHENGINE_H
+#define PATHENGINE_H
+
+#include "gridmap.h"
+#include "searchgrid.h"
+#include "indexedheap.h"
+#include "bucketqueue.h"
+#include "jumptable.h"
+#include "componentindex.h"
+#include "landmarks.h"
+#include "heuristics.h"
+#include "neighborhoods.h"
+#include "searchmetrics.h"
+#include <cstdlib>
+#include <vector>
+
+// 无界面依赖的搜索引擎：可视化程序和后台服务共用同一套搜索内核。
+
+enum class Algorithm {
+    Dijkstra,
+    Greedy,
+    AStar,
+    JumpPoint   // 跳点搜索：只把跳点放进开放集合，结果与 A* 一样最优
+};
+
+struct PathResult {
+    bool found = false;
+    int cost = 0;       // 路径代价（四邻域下等于移动步数）
+    int expanded = 0;   // 扩展的节点数
+    std::vector<GridPoint> path;
+    SearchMetrics metrics;  // 开放集合操作计数与分阶段耗时，ASTAR_METRICS 关闭时全为 0
+};
+
+// 不记录任何步骤的观察者；可视化程序传入自己的记录器来收集每步修改过的单元格
+struct NullRecorder {
+    void touch(int) {}
+};
+
+// 与启发函数、邻域和开放集合无关的搜索状态：搜索网格、路径回溯和跳点规则。
+// 可以反复调用 begin() 复用同一块内存：网格、开放集合按上次查询写过的格子清空，
+// 容量只增不减，同一张地图上连续查询预热后不再分配内存。
+class SearchContextBase {
+public:
+    enum Status {
+        Running,
+        Found,
+        Exhausted
+    };
+
+    // 为 JumpPoint 提供 JPS+ 预计算表（必须由同一张地图构建），nullptr 表示逐格扫描
+    void setJumpTable(const JumpTable *table) { m_jumpTable = table; }
+
+    // 连通分量索引（必须与当前地图一致），nullptr 表示不检查。起点和终点不在同一分量时
+    // begin() 直接结束为 Exhausted，不扩展节点，也不重置搜索网格（尺寸不符时才重新分配）。
+    // 索引的连通方式比邻域分得更细时（见 ComponentIndex::appliesTo）不使用
+    void setComponentIndex(const ComponentIndex *index) { m_components = index; }
+
+    // ALT 地标表（必须由同一张地图按同一种邻域构建），nullptr 表示只用启发函数。
+    // 设置后 AStar、Greedy 和 JumpPoint 的估计值取启发函数与地标下界中较大的一个，仍然一致
+    void setLandmarks(const LandmarkTable *table) { m_landmarks = table; }
+
+    // 加权 A*：f = g + weight * h，weight 小于 1 时按 1 处理，精度为千分之一。
+    // 启发函数一致时路径代价不超过最优值的 weight 倍；只影响 AStar 和 JumpPoint
+    void setHeuristicWeight(double weight);
+    double heuristicWeight() const { return m_weightPermille / 1000.0; }
+
+    Status status() const { return m_status; }
+    Algorithm algorithm() const { return m_algorithm; }
+    const SearchGrid &grid() const { return m_grid; }
+    int expandedCount() const { return m_expanded; }
+
+    // 本次查询（最近一次 begin() 以来）的计数与耗时；run() 计入 Search 阶段，
+    // 单步调用 step() 时由调用方自己计时
+    const SearchMetrics &metrics() const { return m_metrics; }
+
+    // 从终点沿父节点回溯得到路径（起点在前），未找到时为空；跳点之间的格子会被补齐
+    std::vector<GridPoint> path() const;
+    // 同上，写进调用方的 out，复用它的容量
+    void path(std::vector<GridPoint> &out) const;
+
+protected:
+    // 重置搜索网格并以 startH 为启发值初始化起点；返回起点索引，起点不可走时返回 -1
+    int reset(const GridMap &map, GridPoint start, GridPoint goal, Algorithm algorithm, int startH);
+
+    // 起点和终点已知不连通时结束本次查询并返回 true；begin() 在重置搜索网格之前调用
+    bool rejectUnreachable(const GridMap &map, GridPoint start, GridPoint goal, Algorithm algorithm);
+
+    // 按父节点方向剪枝后需要跳跃的方向，返回方向个数
+    int jumpDirections(int index, int directions[4][2]) const;
+
+    // 从 (x, y) 沿 (dx, dy) 跳跃，返回找到的跳点索引，撞墙返回 -1
+    int jump(int x, int y, int dx, int dy) const;
+    int tableJumpVertical(int x, int y, int dy) const;
+
+    int weighted(int h) const {
+        return m_weightPermille == 1000 ? h : int((long long)h * m_weightPermille / 1000);
+    }
+
+    const GridMap *m_map = nullptr;
+    const JumpTable *m_jumpTable = nullptr;
+    const ComponentIndex *m_components = nullptr;
+    const LandmarkTable *m_landmarks = nullptr;
+    const LandmarkTable *m_activeLandmarks = nullptr;           // 本次查询实际使用的表，不适用时为空
+    uint16_t m_goalLandmarks[LandmarkTable::MaxLandmarks] = {};  // 终点到各地标的距离
+    SearchGrid m_grid;
+    Algorithm m_algorithm = Algorithm::AStar;
+    GridPoint m_goal;
+    int m_goalIndex = -1;
+    int m_expanded = 0;
+    int m_weightPermille = 1000;
+    Status m_status = Exhausted;
+    SearchMetrics m_metrics;
+};
+
+// 一次搜索的全部状态。启发函数（heuristics.h）、邻域（neighborhoods.h）和开放集合是模板参数，
+// 每种组合编译成各自的内核，内层循环里的估价和方向展开都是内联的。
+// 地图带代价层时，移动代价乘以目标格的代价；代价有界，开放集合可以换成 BucketQueue。
+// 跳点规则只适用于四邻域的统一代价地图，其余情况下 JumpPoint 按 A* 搜索。
+template <typename Heuristic = Manhattan, typename Neighborhood = FourConnected, typename OpenSet = IndexedHeap<int>>
+class BasicSearchContext : public SearchContextBase {
+public:
+    void begin(const GridMap &map, GridPoint start, GridPoint goal, Algorithm algorithm);
+
+    // 扩展一个节点
+    template <typename Recorder>
+    Status step(Recorder &recorder);
+    Status step() { NullRecorder recorder; return step(recorder); }
+
+    // 一直扩展到找到终点或开放集合为空
+    Status run();
+
+private:
+    template <typename Recorder>
+    void relax(int current, int neighbor, int tentativeG, Recorder &recorder);
+
+    template <typename Recorder>
+    void expandJumpPoints(int current, Recorder &recorder);
+
+    int estimate(int x, int y) const {
+        int h = Heuristic::template estimate<Neighborhood>(std::abs(x - m_goal.x), std::abs(y - m_goal.y));
+        return m_activeLandmarks ? std::max(h, m_activeLandmarks->lowerBound(m_goalLandmarks, x, y)) : h;
+    }
+
+    int heuristic(int x, int y) const {
+        return m_algorithm == Algorithm::Dijkstra ? 0 : estimate(x, y);
+    }
+
+    OpenSet m_open;
+};
+
+// 可视化程序和批量接口使用的默认组合：四邻域、曼哈顿距离、索引堆
+using SearchContext = BasicSearchContext<>;
+
+// 代价地图上的 Dijkstra / A*：键是有界整数，桶队列的入队出队都是常数时间
+using BucketSearchContext = BasicSearchContext<Manhattan, FourConnected, BucketQueue>;
+
+template <typename Heuristic, typename Neighborhood, typename OpenSet>
+void BasicSearchContext<Heuristic, Neighborhood, OpenSet>::begin(const GridMap &map, GridPoint start, GridPoint goal, Algorithm algorithm) {
+    m_metrics.clear();
+    PhaseTimer timer(m_metrics, SearchMetrics::Setup);
+    if ((Neighborhood::AllowsDiagonal || map.hasCosts()) && algorithm == Algorithm::JumpPoint) {
+        algorithm = Algorithm::AStar;
+    }
+    if (m_components && m_components->appliesTo<Neighborhood>() && rejectUnreachable(map, start, goal, algorithm)) {
+        return;
+    }
+    m_goal = goal;
+    m_activeLandmarks = nullptr;
+    if (m_landmarks && m_landmarks->appliesTo<Neighborhood>(map) && map.contains(goal.x, goal.y) && map.contains(start.x, start.y)) {
+        m_landmarks->loadRow(map.index(goal.x, goal.y), m_goalLandmarks);
+        m_activeLandmarks = m_landmarks;
+    }
+    int startH = estimate(start.x, start.y);
+    m_open.reset(map.cellCount());
+    int startIndex = reset(map, start, goal, algorithm, startH);
+    if (startIndex >= 0) {
+        if (m_algorithm == Algorithm::AStar || m_algorithm == Algorithm::JumpPoint) {
+            m_grid.f[startIndex] = weighted(startH);
+        }
+        m_open.push(startIndex, m_grid.f[startIndex]);
+        m_metrics.push(m_open.size());
+    }
+}
+
+template <typename Heuristic, typename Neighborhood, typename OpenSet>
+typename BasicSearchContext<Heuristic, Neighborhood, OpenSet>::Status BasicSearchContext<Heuristic, Neighborhood, OpenSet>::run() {
+    PhaseTimer timer(m_metrics, SearchMetrics::Search);
+    NullRecorder recorder;
+    while (step(recorder) == Running) {
+    }
+    return m_status;
+}
+
+template <typename Heuristic, typename Neighborhood, typename OpenSet>
+template <typename Recorder>
+typename BasicSearchContext<Heuristic, Neighborhood, OpenSet>::Status BasicSearchContext<Heuristic, Neighborhood, OpenSet>::step(Recorder &recorder) {
+    if (m_status != Running) {
+        return m_status;
+    }
+    if (m_open.empty()) {
+        m_status = Exhausted;
+        return m_status;
+    }
+
+    int current = m_open.pop();
+    m_metrics.pop();
+    if (m_grid.isClosed(current)) {
+        m_metrics.stalePop();
+        return m_status;
+    }
+
+    // 将当前节点标记为已关闭
+    m_grid.flags[current] = SearchGrid::Closed;
+    recorder.touch(current);
+    ++m_expanded;
+    m_metrics.expand();
+
+    if (current == m_goalIndex) {
+        m_status = Found;
+        return m_status;
+    }
+
+    if (!Neighborhood::AllowsDiagonal && m_algorithm == Algorithm::JumpPoint) {
+        expandJumpPoints(current, recorder);
+        return m_status;
+    }
+
+    int currentX = m_grid.xOf(current);
+    int currentY = m_grid.yOf(current);
+
+    for (const auto &offset : Neighborhood::Offsets) {
+        int nx = currentX + offset[0];
+        int ny = currentY + offset[1];
+        if (!m_map->contains(nx, ny)) {
+            continue;
+        }
+
+        // 跳过障碍物、已关闭的节点和被墙角挡住的斜向移动
+        int neighbor = m_grid.index(nx, ny);
+        if (m_map->isObstacle(neighbor) || m_grid.isClosed(neighbor)
+            || !Neighborhood::canMove(*m_map, currentX, currentY, offset[0], offset[1])) {
+            continue;
+        }
+
+        int moveCost = Neighborhood::cost(offset[0], offset[1]) * m_map->cost(neighbor);
+        relax(current, neighbor, m_grid.g[current] + moveCost, recorder);
+    }
+
+    return m_status;
+}
+
+template <typename Heuristic, typename Neighborhood, typename OpenSet>
+template <typename Recorder>
+void BasicSearchContext<Heuristic, Neighborhood, OpenSet>::relax(int current, int neighbor, int tentativeG, Recorder &recorder) {
+    if (tentativeG >= m_grid.g[neighbor]) {
+        return;
+    }
+
+    int h = heuristic(m_grid.xOf(neighbor), m_grid.yOf(neighbor));
+    m_grid.touch(neighbor);
+    m_grid.parent[neighbor] = current;
+    m_grid.g[neighbor] = tentativeG;
+    m_grid.h[neighbor] = h;
+    m_grid.f[neighbor] = m_algorithm == Algorithm::Greedy ? h : tentativeG + weighted(h);
+    recorder.touch(neighbor);
+
+    if (!m_grid.isOpen(neighbor)) {
+        m_grid.flags[neighbor] |= SearchGrid::Open;
+        m_open.push(neighbor, m_grid.f[neighbor]);
+        m_metrics.push(m_open.size());
+    } else {
+        m_open.decreaseKey(neighbor, m_grid.f[neighbor]);
+        m_metrics.decreaseKey();
+    }
+}
+
+template <typename Heuristic, typename Neighborhood, typename OpenSet>
+template <typename Recorder>
+void BasicSearchContext<Heuristic, Neighborhood, OpenSet>::expandJumpPoints(int current, Recorder &recorder) {
+    int directions[4][2];
+    int count = jumpDirections(current, directions);
+
+    int currentX = m_grid.xOf(current);
+    int currentY = m_grid.yOf(current);
+
+    for (int i = 0; i < count; ++i) {
+        int jumpPoint = jump(currentX, currentY, directions[i][0], directions[i][1]);
+        if (jumpPoint < 0 || m_grid.isClosed(jumpPoint)) {
+            continue;
+        }
+
+        // 跳跃总是沿直线，代价就是经过的格数乘以直行代价
+        int distance = std::abs(m_grid.xOf(jumpPoint) - currentX) + std::abs(m_grid.yOf(jumpPoint) - currentY);
+        relax(current, jumpPoint, m_grid.g[current] + distance * Neighborhood::StraightCost, recorder);
+    }
+}
+
+// 默认组合在 pathengine.cpp 中显式实例化
+extern template class BasicSearchContext<>;
+
+// 复用调用方提供的搜索上下文和结果，结果的路径写进 result.path 原有的容量里；
+// 两者都跨查询保留时，连续查询不做任何堆分配。
+// cost 以邻域的代价为单位，四邻域的统一代价地图上等于移动步数
+template <typename Heuristic, typename Neighborhood, typename OpenSet>
+void findPath(BasicSearchContext<Heuristic, Neighborhood, OpenSet> &context, const GridMap &map,
+              GridPoint start, GridPoint goal, Algorithm algorithm, PathResult &result) {
+    SearchMetrics reconstruct;
+    context.begin(map, start, goal, algorithm);
+    result.found = false;
+    result.cost = 0;
+    result.path.clear();
+    if (context.run() == SearchContextBase::Found) {
+        PhaseTimer timer(reconstruct, SearchMetrics::Reconstruct);
+        result.found = true;
+        context.path(result.path);
+        result.cost = context.grid().g[map.index(goal.x, goal.y)];
+    }
+    result.expanded = context.expandedCount();
+    result.metrics = context.metrics();
+    result.metrics.merge(reconstruct);
+}
+
+// 复用调用方提供的搜索上下文，连续查询时避免重复分配搜索内存
+template <typename Heuristic, typename Neighborhood, typename OpenSet>
+PathResult findPath(BasicSearchContext<Heuristic, Neighborhood, OpenSet> &context, const GridMap &map,
+                    GridPoint start, GridPoint goal, Algorithm algorithm) {
+    PathResult result;
+    findPath(context, map, start, goal, algorithm, result);
+    return result;
+}
+
+// 单次查询；不记录步骤，适合批量调用。例如 findPath<Octile, EightConnected<>>(map, start, goal, Algorithm::AStar)
+template <typename Heuristic = Manhattan, typename Neighborhood = FourConnected, typename OpenSet = IndexedHeap<int>>
+PathResult findPath(const GridMap &map, GridPoint start, GridPoint goal, Algorithm algorithm) {
+    BasicSearchContext<Heuristic, Neighborhood, OpenSet> context;
+    return findPath(context, map, start, goal, algorithm);
+}
+
+#endif // PATHENGINE_H
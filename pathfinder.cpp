@@ -1,38 +1,100 @@
 #include "pathfinder.h"
+#include "mapfile.h"
+#include "movingai.h"
 #include <QTimer>
 #include <QDebug>
 #include <QMetaObject>
+#include <QThreadPool>
 #include <climits>
+#include <algorithm>
 #include <iostream>
 
+namespace {
+
+// 网格画成一张纹理，尺寸只受步骤历史的内存限制
+const int kMaxGridSize = 2000;
+
+// 小网格用小簇才能看出分层结构；大地图上簇太小会让抽象图过大
+int clusterSizeFor(int gridSize) {
+    return qBound(5, gridSize / 6, int(HierarchicalPathfinder::DefaultClusterSize));
+}
+
+// 随时可停模式：编辑后第一次规划的时间预算，以及之后每次空闲改进的时间片
+const std::chrono::milliseconds kAnytimeBudget(20);
+const std::chrono::milliseconds kAnytimeSlice(10);
+
+// 结果缓存的内存预算；2000×2000 网格的一个关键帧约 68 MB
+const size_t kResultCacheBudget = size_t(256) << 20;
+
+// 地标模式的地标个数：每格 8 个 16 位距离，2000×2000 网格上约 64 MB
+const int kLandmarkCount = 8;
+
+// 收集每一步被修改过的单元格，供步骤历史记录增量
+struct DirtyRecorder {
+    QVector<int> &cells;
+    void touch(int index) { cells.append(index); }
+};
+
+QVariantMap metricsToVariantMap(const SearchMetrics &metrics) {
+    QVariantMap phases;
+    for (int phase = 0; phase < SearchMetrics::PhaseCount; ++phase) {
+        phases[SearchMetrics::phaseName(SearchMetrics::Phase(phase))] = metrics.phaseMilliseconds(SearchMetrics::Phase(phase));
+    }
+    
+    QVariantMap map;
+    map["expansions"] = metrics.expansions;
+    map["pushes"] = metrics.pushes;
+    map["pops"] = metrics.pops;
+    map["decreaseKeys"] = metrics.decreaseKeys;
+    map["stalePops"] = metrics.stalePops;
+    map["peakOpenSize"] = metrics.peakOpenSize;
+    map["phasesMs"] = phases;
+    return map;
+}
+
+}
+
 Pathfinder::Pathfinder(QObject *parent) 
     : QObject(parent), 
       m_gridSize(15), 
       m_start(0,0), 
       m_end(14,14), 
       m_simulationTimer(new QTimer(this)),
-      m_dijkstraState([](Cell* a, Cell* b) { return a->g > b->g; }),
-      m_greedyState([](Cell* a, Cell* b) { return a->h > b->h; }),
-      m_aStarState([](Cell* a, Cell* b) { return a->f > b->f; }),
       m_progress(0),
       m_maxProgress(0),
       m_isRunning(false),
-      m_needsRecomputation(true)
+      m_needsRecomputation(true),
+      m_generation(0),
+      m_pendingResults(0),
+      m_pendingProgress(0),
+      m_incrementalMode(false),
+      m_hierarchical(clusterSizeFor(m_gridSize)),
+      m_hierarchicalMode(false),
+      m_heuristicWeight(1.0),
+      m_bidirectionalMode(false),
+      m_landmarkMode(false),
+      m_landmarkHash(0),
+      m_anytimeTimer(new QTimer(this)),
+      m_anytimeMode(false),
+      m_resultCache(kResultCacheBudget)
 {
-    std::cout << "=== PATHFINDER CONSTRUCTOR ===" << std::endl;
-    
     // 初始化障碍物网格
-    m_obstacles.resize(m_gridSize);
-    for (int i = 0; i < m_gridSize; ++i) {
-        m_obstacles[i].resize(m_gridSize);
-        for (int j = 0; j < m_gridSize; ++j) {
-            m_obstacles[i][j] = false;
-        }
+    m_map = GridMap(m_gridSize, m_gridSize);
+    m_components.build(m_map);
+    
+    // 每个算法各占一个线程
+    m_workerPool.setMaxThreadCount(4);
+    
+    for (int i = 0; i < 4; ++i) {
+        m_cellModels[i] = new GridCellModel(this);
+        m_modelSteps[i] = -1;
+        m_modelFinalPaths[i] = false;
     }
+    connect(this, &Pathfinder::gridChanged, this, [this]() {
+        refreshCellModels();
+    });
     
-    std::cout << "Calling recomputeAllAlgorithms from constructor..." << std::endl;
-    recomputeAllAlgorithms();
-    std::cout << "Constructor finished." << std::endl;
+    recomputeAllAlgorithms(0);
     
     connect(m_simulationTimer, &QTimer::timeout, this, [this]() {
         if (m_progress < m_maxProgress) {
@@ -44,6 +106,23 @@ Pathfinder::Pathfinder(QObject *parent)
     
     // 设置定时器间隔为50ms
     m_simulationTimer->setInterval(50);
+    
+    // 事件循环空闲时继续改进随时可停路径，每次只占用一个时间片
+    m_anytimeTimer->setInterval(0);
+    connect(m_anytimeTimer, &QTimer::timeout, this, [this]() {
+        if (m_anytime.improve(AnytimePlanner::Clock::now() + kAnytimeSlice)) {
+            m_anytimeTimer->stop();
+        }
+        emit anytimePathChanged();
+    });
+}
+
+Pathfinder::~Pathfinder() {
+    // 作废仍在运行的任务并等待它们退出，之后不会再有结果投递到本对象
+    if (m_cancelToken) {
+        m_cancelToken->store(true);
+    }
+    m_workerPool.waitForDone();
 }
 
 int Pathfinder::gridSize() const {
@@ -51,23 +130,112 @@ int Pathfinder::gridSize() const {
 }
 
 void Pathfinder::setGridSize(int size) {
-    if (m_gridSize != size && size >= 5 && size <= 30) {
-        m_gridSize = size;
-        m_start = QPoint(0, 0);
-        m_end = QPoint(size-1, size-1);
-        
-        m_obstacles.resize(m_gridSize);
-        for (int i = 0; i < m_gridSize; ++i) {
-            m_obstacles[i].resize(m_gridSize);
-            for (int j = 0; j < m_gridSize; ++j) {
-                m_obstacles[i][j] = false;
+    if (m_gridSize != size && size >= 5 && size <= kMaxGridSize) {
+        adoptMap(GridMap(size, size), QPoint(0, 0), QPoint(size - 1, size - 1));
+    }
+}
+
+void Pathfinder::adoptMap(GridMap map, const QPoint &start, const QPoint &end) {
+    bool sizeChanged = m_gridSize != map.width();
+    m_gridSize = map.width();
+    m_map = std::move(map);
+    m_components.build(m_map);
+    m_start = start;
+    m_end = end;
+    
+    // 尺寸不变时模型不会整体重置，需要逐格比较才能画出新地图的障碍物
+    for (int i = 0; i < 4; ++i) {
+        m_modelSteps[i] = -1;
+    }
+    if (!sizeChanged) {
+        refreshCellModels();
+    }
+    
+    m_needsRecomputation = true;
+    resetSimulation();
+    if (sizeChanged) {
+        emit gridSizeChanged();
+    }
+    emit startChanged();
+    emit endChanged();
+    
+    if (m_incrementalMode) {
+        m_planner.reset(m_map, {m_start.x(), m_start.y()}, {m_end.x(), m_end.y()});
+        replanIncremental();
+    }
+    if (m_hierarchicalMode) {
+        rebuildHierarchical();
+    }
+    if (m_anytimeMode) {
+        replanAnytime();
+    }
+}
+
+bool Pathfinder::loadMap(const QUrl &file) {
+    std::string path = (file.isLocalFile() ? file.toLocalFile() : file.toString()).toStdString();
+    
+    GridMap loaded;
+    std::string error;
+    bool binary = path.size() >= sizeof(MapFile::Extension) - 1
+               && path.compare(path.size() - (sizeof(MapFile::Extension) - 1), std::string::npos, MapFile::Extension) == 0;
+    bool ok = binary ? MapFile::open(path, loaded, &error) : MovingAi::loadMap(path, loaded, &error);
+    if (!ok) {
+        qWarning("Cannot load map: %s", error.c_str());
+        return false;
+    }
+    
+    int size = qMax(qMax(loaded.width(), loaded.height()), 5);
+    if (size > kMaxGridSize) {
+        qWarning("Map is %dx%d, larger than the %d cell limit", loaded.width(), loaded.height(), kMaxGridSize);
+        return false;
+    }
+    
+    // 界面只显示正方形网格：正方形地图直接使用（映射的文件不复制），否则逐格拷贝并补障碍物
+    GridMap square;
+    if (loaded.width() == size && loaded.height() == size) {
+        square = std::move(loaded);
+    } else {
+        square = GridMap(size, size);
+        for (int y = 0; y < size; ++y) {
+            for (int x = 0; x < size; ++x) {
+                bool inside = loaded.contains(x, y);
+                if (!inside || loaded.isObstacle(x, y)) {
+                    square.setObstacle(x, y, true);
+                } else if (loaded.hasCosts()) {
+                    square.setCost(x, y, loaded.cost(x, y));
+                }
             }
         }
-        
-        m_needsRecomputation = true;
-        resetSimulation();
-        emit gridSizeChanged();
     }
+    
+    // 起点取左上角开始的第一个可走格，终点取右下角开始的第一个可走格
+    int first = -1;
+    int last = -1;
+    for (int index = 0; index < square.cellCount() && first < 0; ++index) {
+        if (!square.isObstacle(index)) first = index;
+    }
+    for (int index = square.cellCount() - 1; index >= 0 && last < 0; --index) {
+        if (!square.isObstacle(index)) last = index;
+    }
+    if (first < 0 || first == last) {
+        qWarning("Map needs at least two passable cells");
+        return false;
+    }
+    
+    QPoint start(first % size, first / size);
+    QPoint end(last % size, last / size);
+    adoptMap(std::move(square), start, end);
+    return true;
+}
+
+bool Pathfinder::saveMap(const QUrl &file) const {
+    std::string path = (file.isLocalFile() ? file.toLocalFile() : file.toString()).toStdString();
+    std::string error;
+    if (!MapFile::save(m_map, path, &error)) {
+        qWarning("Cannot save map: %s", error.c_str());
+        return false;
+    }
+    return true;
 }
 
 QPoint Pathfinder::start() const {
@@ -75,38 +243,34 @@ QPoint Pathfinder::start() const {
 }
 
 void Pathfinder::setStart(const QPoint &point) {
-    std::cout << "=== SET START CALLED ===" << std::endl;
-    std::cout << "New start: (" << point.x() << "," << point.y() << ")" << std::endl;
-    std::cout << "Current start: (" << m_start.x() << "," << m_start.y() << ")" << std::endl;
-    std::cout << "Current progress: " << m_progress << std::endl;
-    
     if (m_start != point && 
         point.x() >= 0 && point.x() < m_gridSize && 
         point.y() >= 0 && point.y() < m_gridSize &&
-        !m_obstacles[point.y()][point.x()] &&
+        !m_map.isObstacle(point.x(), point.y()) &&
         !(point.x() == m_end.x() && point.y() == m_end.y())) {
         
         m_start = point;
         m_needsRecomputation = true;
-        std::cout << "✅ Start position updated" << std::endl;
         
-        // 保存当前进度
-        int oldProgress = m_progress;
+        // 后台重新计算，结果返回后恢复当前进度（超出新的最大进度时跳到最后一步）
+        recomputeAllAlgorithms(m_progress);
         
-        recomputeAllAlgorithms();
+        // 起点是增量搜索树的根，移动起点会让规划器重新初始化
+        if (m_incrementalMode) {
+            m_planner.setStart({m_start.x(), m_start.y()});
+            replanIncremental();
+        }
         
-        // 如果旧进度大于新最大进度，跳到最后一步
-        if (oldProgress > m_maxProgress) {
-            setProgress(m_maxProgress);
-        } else {
-            setProgress(oldProgress);
+        // 抽象图与起点终点无关，只需重新查询
+        if (m_hierarchicalMode) {
+            replanHierarchical();
+        }
+        if (m_anytimeMode) {
+            replanAnytime();
         }
         
         emit startChanged();
-    } else {
-        std::cout << "❌ Cannot set start - invalid conditions" << std::endl;
     }
-    std::cout << "=== SET START FINISHED ===" << std::endl;
 }
 
 QPoint Pathfinder::end() const {
@@ -114,38 +278,31 @@ QPoint Pathfinder::end() const {
 }
 
 void Pathfinder::setEnd(const QPoint &point) {
-    std::cout << "=== SET END CALLED ===" << std::endl;
-    std::cout << "New end: (" << point.x() << "," << point.y() << ")" << std::endl;
-    std::cout << "Current end: (" << m_end.x() << "," << m_end.y() << ")" << std::endl;
-    std::cout << "Current progress: " << m_progress << std::endl;
-    
     if (m_end != point && 
         point.x() >= 0 && point.x() < m_gridSize && 
         point.y() >= 0 && point.y() < m_gridSize &&
-        !m_obstacles[point.y()][point.x()] &&
+        !m_map.isObstacle(point.x(), point.y()) &&
         !(point.x() == m_start.x() && point.y() == m_start.y())) {
         
         m_end = point;
         m_needsRecomputation = true;
-        std::cout << "✅ End position updated" << std::endl;
         
-        // 保存当前进度
-        int oldProgress = m_progress;
+        // 后台重新计算，结果返回后恢复当前进度（超出新的最大进度时跳到最后一步）
+        recomputeAllAlgorithms(m_progress);
         
-        recomputeAllAlgorithms();
-        
-        // 如果旧进度大于新最大进度，跳到最后一步
-        if (oldProgress > m_maxProgress) {
-            setProgress(m_maxProgress);
-        } else {
-            setProgress(oldProgress);
+        if (m_incrementalMode) {
+            m_planner.setGoal({m_end.x(), m_end.y()});
+            replanIncremental();
+        }
+        if (m_hierarchicalMode) {
+            replanHierarchical();
+        }
+        if (m_anytimeMode) {
+            replanAnytime();
         }
         
         emit endChanged();
-    } else {
-        std::cout << "❌ Cannot set end - invalid conditions" << std::endl;
     }
-    std::cout << "=== SET END FINISHED ===" << std::endl;
 }
 
 int Pathfinder::progress() const {
@@ -155,12 +312,6 @@ int Pathfinder::progress() const {
 void Pathfinder::setProgress(int progress) {
     if (m_progress != progress && progress >= 0 && progress <= m_maxProgress) {
         m_progress = progress;
-        
-        std::cout << "setProgress: " << progress 
-                  << ", Dijkstra steps: " << m_dijkstraState.stepGrids.size()
-                  << ", Greedy steps: " << m_greedyState.stepGrids.size()
-                  << ", A* steps: " << m_aStarState.stepGrids.size() << std::endl;
-        
         emit progressChanged();
         emit gridChanged();
     }
@@ -174,48 +325,221 @@ bool Pathfinder::isRunning() const {
     return m_isRunning;
 }
 
-void Pathfinder::toggleObstacle(int x, int y) {
-    std::cout << "=== TOGGLE OBSTACLE CALLED ===" << std::endl;
-    std::cout << "Coordinates: (" << x << "," << y << ")" << std::endl;
-    std::cout << "Current progress: " << m_progress << std::endl;
-    std::cout << "Start position: (" << m_start.x() << "," << m_start.y() << ")" << std::endl;
-    std::cout << "End position: (" << m_end.x() << "," << m_end.y() << ")" << std::endl;
-    std::cout << "Grid bounds: 0 to " << m_gridSize-1 << std::endl;
+bool Pathfinder::isComputing() const {
+    return m_pendingResults > 0;
+}
+
+bool Pathfinder::incrementalMode() const {
+    return m_incrementalMode;
+}
+
+void Pathfinder::setIncrementalMode(bool enabled) {
+    if (m_incrementalMode == enabled) {
+        return;
+    }
+    
+    m_incrementalMode = enabled;
+    if (enabled) {
+        // 开启时做一次完整规划，之后的编辑都在这个状态上增量修复
+        m_planner.reset(m_map, {m_start.x(), m_start.y()}, {m_end.x(), m_end.y()});
+        replanIncremental();
+    }
+    emit incrementalModeChanged();
+    if (!enabled) {
+        emit incrementalPathChanged();
+    }
+}
+
+QVariantList Pathfinder::incrementalPath() const {
+    QVariantList result;
+    if (!m_incrementalMode) {
+        return result;
+    }
+    for (const GridPoint &point : m_planner.path()) {
+        result.append(QPoint(point.x, point.y));
+    }
+    return result;
+}
+
+int Pathfinder::incrementalExpanded() const {
+    return m_incrementalMode ? m_planner.lastExpanded() : 0;
+}
+
+void Pathfinder::replanIncremental() {
+    m_planner.computePath();
+    emit incrementalPathChanged();
+}
+
+bool Pathfinder::hierarchicalMode() const {
+    return m_hierarchicalMode;
+}
+
+void Pathfinder::setHierarchicalMode(bool enabled) {
+    if (m_hierarchicalMode == enabled) {
+        return;
+    }
+    
+    m_hierarchicalMode = enabled;
+    if (enabled) {
+        rebuildHierarchical();
+    } else {
+        m_hierarchicalResult = PathResult();
+        emit hierarchicalPathChanged();
+    }
+    emit hierarchicalModeChanged();
+}
+
+QVariantList Pathfinder::hierarchicalPath() const {
+    QVariantList result;
+    for (const GridPoint &point : m_hierarchicalResult.path) {
+        result.append(QPoint(point.x, point.y));
+    }
+    return result;
+}
+
+int Pathfinder::hierarchicalExpanded() const {
+    return m_hierarchicalResult.expanded;
+}
+
+void Pathfinder::rebuildHierarchical() {
+    if (m_hierarchical.clusterSize() != clusterSizeFor(m_gridSize)) {
+        m_hierarchical = HierarchicalPathfinder(clusterSizeFor(m_gridSize));
+    }
+    m_hierarchical.build(m_map);
+    replanHierarchical();
+}
+
+void Pathfinder::replanHierarchical() {
+    m_hierarchicalResult = m_hierarchical.findPath({m_start.x(), m_start.y()}, {m_end.x(), m_end.y()});
+    emit hierarchicalPathChanged();
+}
+
+double Pathfinder::heuristicWeight() const {
+    return m_heuristicWeight;
+}
+
+void Pathfinder::setHeuristicWeight(double weight) {
+    weight = qBound(1.0, weight, 10.0);
+    if (qFuzzyCompare(m_heuristicWeight, weight)) {
+        return;
+    }
+    
+    m_heuristicWeight = weight;
+    m_needsRecomputation = true;
+    recomputeAllAlgorithms(m_progress);
+    emit heuristicWeightChanged();
+}
+
+bool Pathfinder::bidirectionalMode() const {
+    return m_bidirectionalMode;
+}
+
+void Pathfinder::setBidirectionalMode(bool enabled) {
+    if (m_bidirectionalMode == enabled) {
+        return;
+    }
+    
+    m_bidirectionalMode = enabled;
+    m_needsRecomputation = true;
+    recomputeAllAlgorithms(m_progress);
+    emit bidirectionalModeChanged();
+}
+
+bool Pathfinder::landmarkMode() const {
+    return m_landmarkMode;
+}
+
+void Pathfinder::setLandmarkMode(bool enabled) {
+    if (m_landmarkMode == enabled) {
+        return;
+    }
+    
+    m_landmarkMode = enabled;
+    m_needsRecomputation = true;
+    recomputeAllAlgorithms(m_progress);
+    emit landmarkModeChanged();
+}
+
+bool Pathfinder::anytimeMode() const {
+    return m_anytimeMode;
+}
+
+void Pathfinder::setAnytimeMode(bool enabled) {
+    if (m_anytimeMode == enabled) {
+        return;
+    }
     
+    m_anytimeMode = enabled;
+    if (enabled) {
+        replanAnytime();
+    } else {
+        m_anytimeTimer->stop();
+        m_anytime = AnytimePlanner();
+        emit anytimePathChanged();
+    }
+    emit anytimeModeChanged();
+}
+
+QVariantList Pathfinder::anytimePath() const {
+    QVariantList result;
+    for (const GridPoint &point : m_anytime.result().path) {
+        result.append(QPoint(point.x, point.y));
+    }
+    return result;
+}
+
+double Pathfinder::anytimeBound() const {
+    return m_anytime.bound();
+}
+
+int Pathfinder::anytimeExpanded() const {
+    return m_anytime.result().expanded;
+}
+
+void Pathfinder::replanAnytime() {
+    m_anytime.search(m_map, {m_start.x(), m_start.y()}, {m_end.x(), m_end.y()}, kAnytimeBudget);
+    if (m_anytime.isFinished()) {
+        m_anytimeTimer->stop();
+    } else {
+        m_anytimeTimer->start();
+    }
+    emit anytimePathChanged();
+}
+
+void Pathfinder::toggleObstacle(int x, int y) {
     // 移除进度限制，允许在任何步骤修改
     if (x >= 0 && x < m_gridSize && y >= 0 && y < m_gridSize &&
         !(x == m_start.x() && y == m_start.y()) && 
         !(x == m_end.x() && y == m_end.y())) {
         
-        bool newState = !m_obstacles[y][x];
-        m_obstacles[y][x] = newState;
-        std::cout << "✅ Obstacle toggled at (" << x << "," << y << ") to: " << newState << std::endl;
+        bool newState = !m_map.isObstacle(x, y);
+        m_map.setObstacle(x, y, newState);
+        m_components.update(m_map, x, y);
+        
+        // 障碍物立即显示，不必等后台结果
+        refreshCellModels({m_map.index(x, y)});
         
         m_needsRecomputation = true;
         
-        // 保存当前进度
-        int oldProgress = m_progress;
+        // 后台重新计算所有算法，结果返回后恢复当前进度（超出新的最大进度时跳到最后一步）
+        recomputeAllAlgorithms(m_progress);
         
-        // 重新计算所有算法
-        recomputeAllAlgorithms();
+        // 增量规划器只修复这个格子周围受影响的 g 值
+        if (m_incrementalMode) {
+            m_planner.setObstacle(x, y, newState);
+            replanIncremental();
+        }
         
-        // 如果旧进度大于新最大进度，跳到最后一步
-        if (oldProgress > m_maxProgress) {
-            setProgress(m_maxProgress);
-        } else {
-            // 否则保持当前进度（重新计算会重置为0，需要恢复）
-            setProgress(oldProgress);
+        // 分层抽象图只重建这个格子所在的簇及其相邻簇
+        if (m_hierarchicalMode) {
+            m_hierarchical.setObstacle(x, y, newState);
+            replanHierarchical();
+        }
+        
+        if (m_anytimeMode) {
+            replanAnytime();
         }
-    } else {
-        std::cout << "❌ Cannot toggle obstacle - invalid conditions:" << std::endl;
-        if (x < 0 || x >= m_gridSize || y < 0 || y >= m_gridSize) 
-            std::cout << "  - Coordinates out of bounds" << std::endl;
-        if (x == m_start.x() && y == m_start.y()) 
-            std::cout << "  - Cell is start position" << std::endl;
-        if (x == m_end.x() && y == m_end.y()) 
-            std::cout << "  - Cell is end position" << std::endl;
     }
-    std::cout << "=== TOGGLE OBSTACLE FINISHED ===" << std::endl;
 }
 
 void Pathfinder::stepForward() {
@@ -226,19 +550,19 @@ void Pathfinder::stepForward() {
         bool anyProgress = false;
         
         if (!m_dijkstraState.finished) {
-            anyProgress |= stepAlgorithm(m_dijkstraState, [](int, int, int, int) { return 0; }, true);
+            anyProgress |= stepAlgorithm(m_dijkstraState);
         }
         
         if (!m_greedyState.finished) {
-            anyProgress |= stepAlgorithm(m_greedyState, [this](int x1, int y1, int x2, int y2) { 
-                return heuristic(x1, y1, x2, y2); 
-            }, false);
+            anyProgress |= stepAlgorithm(m_greedyState);
         }
         
         if (!m_aStarState.finished) {
-            anyProgress |= stepAlgorithm(m_aStarState, [this](int x1, int y1, int x2, int y2) { 
-                return heuristic(x1, y1, x2, y2); 
-            }, true);
+            anyProgress |= stepAlgorithm(m_aStarState);
+        }
+        
+        if (!m_jumpPointState.finished) {
+            anyProgress |= stepAlgorithm(m_jumpPointState);
         }
         
         if (anyProgress) {
@@ -272,50 +596,43 @@ void Pathfinder::stopSimulation() {
 }
 
 void Pathfinder::resetSimulation() {
-    std::cout << "Resetting simulation..." << std::endl;
-    std::cout << "Current needsRecomputation: " << m_needsRecomputation << std::endl;
-    
     stopSimulation();
     m_progress = 0;
     
     if (m_needsRecomputation) {
-        std::cout << "Recomputation needed, recomputing algorithms..." << std::endl;
-        recomputeAllAlgorithms();
+        emit progressChanged();
+        recomputeAllAlgorithms(0);
     } else {
-        std::cout << "No recomputation needed, just resetting progress." << std::endl;
         emit progressChanged();
         emit gridChanged();
     }
-    
-    std::cout << "Simulation reset to progress 0" << std::endl;
-    std::cout << "Needs recomputation after reset: " << m_needsRecomputation << std::endl;
 }
 
 void Pathfinder::clearAllObstacles() {
-    std::cout << "=== CLEAR ALL OBSTACLES CALLED ===" << std::endl;
-    
     // 移除进度限制
-    for (int y = 0; y < m_gridSize; ++y) {
-        for (int x = 0; x < m_gridSize; ++x) {
-            m_obstacles[y][x] = false;
-        }
+    m_map.clearObstacles();
+    m_components.build(m_map);
+    
+    for (int i = 0; i < 4; ++i) {
+        m_modelSteps[i] = -1;
     }
+    refreshCellModels();
     
     m_needsRecomputation = true;
     
-    // 保存当前进度
-    int oldProgress = m_progress;
+    // 后台重新计算，结果返回后恢复当前进度（超出新的最大进度时跳到最后一步）
+    recomputeAllAlgorithms(m_progress);
     
-    recomputeAllAlgorithms();
-    
-    // 如果旧进度大于新最大进度，跳到最后一步
-    if (oldProgress > m_maxProgress) {
-        setProgress(m_maxProgress);
-    } else {
-        setProgress(oldProgress);
+    if (m_incrementalMode) {
+        m_planner.reset(m_map, {m_start.x(), m_start.y()}, {m_end.x(), m_end.y()});
+        replanIncremental();
+    }
+    if (m_hierarchicalMode) {
+        rebuildHierarchical();
+    }
+    if (m_anytimeMode) {
+        replanAnytime();
     }
-    
-    std::cout << "✅ All obstacles cleared" << std::endl;
 }
 
 void Pathfinder::debugPrintGrids() {
@@ -326,49 +643,60 @@ void Pathfinder::debugPrintGrids() {
     std::cout << "Needs recomputation: " << m_needsRecomputation << std::endl;
     
     std::cout << "\n--- Current QML Data ---" << std::endl;
-    std::cout << "Dijkstra data available: " << (m_progress < m_dijkstraState.stepGrids.size()) 
-              << " (progress " << m_progress << " < " << m_dijkstraState.stepGrids.size() << ")" << std::endl;
-    std::cout << "Greedy data available: " << (m_progress < m_greedyState.stepGrids.size()) 
-              << " (progress " << m_progress << " < " << m_greedyState.stepGrids.size() << ")" << std::endl;
-    std::cout << "A* data available: " << (m_progress < m_aStarState.stepGrids.size()) 
-              << " (progress " << m_progress << " < " << m_aStarState.stepGrids.size() << ")" << std::endl;
-    
-    if (m_progress < m_dijkstraState.stepGrids.size()) {
+    std::cout << "Dijkstra data available: " << (m_progress < m_dijkstraState.history.stepCount()) 
+              << " (progress " << m_progress << " < " << m_dijkstraState.history.stepCount() << ")" << std::endl;
+    std::cout << "Greedy data available: " << (m_progress < m_greedyState.history.stepCount()) 
+              << " (progress " << m_progress << " < " << m_greedyState.history.stepCount() << ")" << std::endl;
+    std::cout << "A* data available: " << (m_progress < m_aStarState.history.stepCount()) 
+              << " (progress " << m_progress << " < " << m_aStarState.history.stepCount() << ")" << std::endl;
+    std::cout << "JPS data available: " << (m_progress < m_jumpPointState.history.stepCount()) 
+              << " (progress " << m_progress << " < " << m_jumpPointState.history.stepCount() << ")" << std::endl;
+    
+    if (m_progress < m_dijkstraState.history.stepCount()) {
         std::cout << "\n--- Dijkstra Internal ---" << std::endl;
-        debugPrintGrid("Dijkstra", m_dijkstraState.stepGrids[m_progress], 
+        debugPrintGrid("Dijkstra", m_dijkstraState.history.gridAt(m_progress), 
                       m_progress < m_dijkstraState.stepPaths.size() ? 
                       m_dijkstraState.stepPaths[m_progress] : QVector<QPoint>());
     }
     
-    if (m_progress < m_greedyState.stepGrids.size()) {
+    if (m_progress < m_greedyState.history.stepCount()) {
         std::cout << "\n--- Greedy Internal ---" << std::endl;
-        debugPrintGrid("Greedy", m_greedyState.stepGrids[m_progress],
+        debugPrintGrid("Greedy", m_greedyState.history.gridAt(m_progress),
                       m_progress < m_greedyState.stepPaths.size() ?
                       m_greedyState.stepPaths[m_progress] : QVector<QPoint>());
     }
     
-    if (m_progress < m_aStarState.stepGrids.size()) {
+    if (m_progress < m_aStarState.history.stepCount()) {
         std::cout << "\n--- A* Internal ---" << std::endl;
-        debugPrintGrid("A*", m_aStarState.stepGrids[m_progress],
+        debugPrintGrid("A*", m_aStarState.history.gridAt(m_progress),
                       m_progress < m_aStarState.stepPaths.size() ?
                       m_aStarState.stepPaths[m_progress] : QVector<QPoint>());
     }
     
+    if (m_progress < m_jumpPointState.history.stepCount()) {
+        std::cout << "\n--- JPS Internal ---" << std::endl;
+        debugPrintGrid("JPS", m_jumpPointState.history.gridAt(m_progress),
+                      m_progress < m_jumpPointState.stepPaths.size() ?
+                      m_jumpPointState.stepPaths[m_progress] : QVector<QPoint>());
+    }
+    
     std::cout << "\n--- Algorithm State ---" << std::endl;
-    std::cout << "Dijkstra total steps: " << m_dijkstraState.stepGrids.size() << std::endl;
-    std::cout << "Greedy total steps: " << m_greedyState.stepGrids.size() << std::endl;
-    std::cout << "A* total steps: " << m_aStarState.stepGrids.size() << std::endl;
+    std::cout << "Dijkstra total steps: " << m_dijkstraState.history.stepCount() << std::endl;
+    std::cout << "Greedy total steps: " << m_greedyState.history.stepCount() << std::endl;
+    std::cout << "A* total steps: " << m_aStarState.history.stepCount() << std::endl;
+    std::cout << "JPS total steps: " << m_jumpPointState.history.stepCount() << std::endl;
     std::cout << "Dijkstra finished: " << m_dijkstraState.finished << std::endl;
     std::cout << "Greedy finished: " << m_greedyState.finished << std::endl;
     std::cout << "A* finished: " << m_aStarState.finished << std::endl;
+    std::cout << "JPS finished: " << m_jumpPointState.finished << std::endl;
 }
 
-void Pathfinder::debugPrintGrid(const QString& name, const QVector<QVector<Cell>>& grid, const QVector<QPoint>& path) const {
+void Pathfinder::debugPrintGrid(const QString& name, const SearchGrid& grid, const QVector<QPoint>& path) const {
     std::cout << name.toStdString() << " Grid:" << std::endl;
     
     for (int y = 0; y < m_gridSize; ++y) {
         for (int x = 0; x < m_gridSize; ++x) {
-            const Cell &cell = grid[y][x];
+            int index = grid.index(x, y);
             
             bool inPath = false;
             for (const QPoint &p : path) {
@@ -381,10 +709,10 @@ void Pathfinder::debugPrintGrid(const QString& name, const QVector<QVector<Cell>
             char symbol = '.';
             if (x == m_start.x() && y == m_start.y()) symbol = 'S';
             else if (x == m_end.x() && y == m_end.y()) symbol = 'E';
-            else if (cell.isObstacle) symbol = '#';
+            else if (m_map.isObstacle(index)) symbol = '#';
             else if (inPath) symbol = '*';
-            else if (cell.isOpen) symbol = 'O';
-            else if (cell.isClosed) symbol = 'C';
+            else if (grid.isOpen(index)) symbol = 'O';
+            else if (grid.isClosed(index)) symbol = 'C';
             
             std::cout << symbol << " ";
         }
@@ -394,380 +722,555 @@ void Pathfinder::debugPrintGrid(const QString& name, const QVector<QVector<Cell>
     std::cout << "Legend: S=Start, E=End, #=Wall, *=Path, O=Open, C=Closed, .=Unexplored" << std::endl;
     
     int openCount = 0, closedCount = 0, pathCount = path.size();
-    for (int y = 0; y < m_gridSize; ++y) {
-        for (int x = 0; x < m_gridSize; ++x) {
-            const Cell &cell = grid[y][x];
-            if (cell.isOpen) openCount++;
-            if (cell.isClosed) closedCount++;
-        }
+    for (int index = 0; index < grid.cellCount(); ++index) {
+        if (grid.isOpen(index)) openCount++;
+        if (grid.isClosed(index)) closedCount++;
     }
     
     std::cout << "Stats: Open=" << openCount << ", Closed=" << closedCount << ", Path=" << pathCount << std::endl;
 }
 
-QVector<QVector<Pathfinder::Cell>> Pathfinder::deepCopyGrid(const QVector<QVector<Cell>>& source) const {
-    QVector<QVector<Cell>> copy;
-    copy.resize(m_gridSize);
+void Pathfinder::StepHistory::clear() {
+    keyframes.clear();
+    keyframeSteps.clear();
+    deltas.clear();
+    stepOffsets.clear();
+    deltasSinceKeyframe = 0;
+    cachedGrid = SearchGrid();
+    cachedStep = -1;
+}
+
+void Pathfinder::StepHistory::applyDeltas(SearchGrid& grid, int fromStep, int toStep) const {
+    if (fromStep > toStep) {
+        return;
+    }
     
-    for (int y = 0; y < m_gridSize; ++y) {
-        copy[y].resize(m_gridSize);
-        for (int x = 0; x < m_gridSize; ++x) {
-            copy[y][x] = Cell(source[y][x]);
-        }
+    int begin = stepOffsets[fromStep];
+    int end = toStep + 1 < stepOffsets.size() ? stepOffsets[toStep + 1] : deltas.size();
+    for (int i = begin; i < end; ++i) {
+        grid.setCellState(deltas[i].index, deltas[i].state);
+    }
+}
+
+bool Pathfinder::StepHistory::collectChangedCells(int fromStep, int toStep, int limit, QVector<int>& out) const {
+    int low = qMin(fromStep, toStep);
+    int high = qMax(fromStep, toStep);
+    if (low == high) {
+        return true;
     }
     
-    return copy;
+    // 第 low 步之后、到第 high 步为止的增量覆盖了两步之间所有不同的单元格
+    int begin = stepOffsets[low + 1];
+    int end = high + 1 < stepOffsets.size() ? stepOffsets[high + 1] : deltas.size();
+    if (end - begin > limit) {
+        return false;
+    }
+    for (int i = begin; i < end; ++i) {
+        out.append(deltas[i].index);
+    }
+    return true;
 }
 
-void Pathfinder::initializeGrids() {
-    std::cout << "=== INITIALIZING GRIDS ===" << std::endl;
+const SearchGrid& Pathfinder::StepHistory::gridAt(int step) const {
+    if (stepCount() == 0) {
+        return cachedGrid;
+    }
+    step = qBound(0, step, stepCount() - 1);
+    if (step == cachedStep) {
+        return cachedGrid;
+    }
+    
+    // 找到不晚于 step 的最近关键帧
+    int k = int(std::upper_bound(keyframeSteps.begin(), keyframeSteps.end(), step) - keyframeSteps.begin()) - 1;
+    int keyStep = keyframeSteps[k];
+    
+    if (cachedStep >= keyStep && cachedStep < step) {
+        // 顺序前进：缓存已经比关键帧更近，只应用新增的步骤
+        applyDeltas(cachedGrid, cachedStep + 1, step);
+    } else {
+        cachedGrid = keyframes[k];
+        applyDeltas(cachedGrid, keyStep + 1, step);
+    }
+    
+    cachedStep = step;
+    return cachedGrid;
+}
+
+// 记录一步：只保存本步修改过的单元格；累计增量达到一整张网格时再存一个关键帧，
+// 这样内存与增量总量成正比，重建任意一步的代价也不超过一次整网格拷贝
+void Pathfinder::recordStep(AlgorithmState &state) {
+    PhaseTimer timer(state.timing, SearchMetrics::Record);
+    StepHistory &history = state.history;
+    
+    history.stepOffsets.append(history.deltas.size());
+    for (int index : state.dirtyCells) {
+        history.deltas.append({index, state.cellState(index)});
+    }
+    history.deltasSinceKeyframe += state.dirtyCells.size();
+    state.dirtyCells.clear();
+    
+    if (history.keyframes.isEmpty() || history.deltasSinceKeyframe >= state.map->cellCount()) {
+        history.keyframes.append(state.grid());
+        history.keyframeSteps.append(history.stepCount() - 1);
+        history.deltasSinceKeyframe = 0;
+    }
+}
+
+void Pathfinder::initializeState(AlgorithmState &state, const std::shared_ptr<const GridMap> &map, GridPoint start, GridPoint goal,
+                                 double heuristicWeight, bool bidirectional,
+                                 const std::shared_ptr<const LandmarkTable> &landmarks,
+                                 const ComponentIndex *components) {
+    state.map = map;
+    state.timing.clear();
+    if (bidirectional && (state.algorithm == Algorithm::Dijkstra || state.algorithm == Algorithm::AStar)) {
+        // 双向搜索总是最优的，不使用启发权重
+        state.bidirectional.reset(new BidirectionalSearchContext);
+        state.bidirectional->setComponentIndex(components);
+        state.bidirectional->begin(*map, start, goal, state.algorithm);
+    } else {
+        // 只有 A* 面板使用权重，JPS 面板保持最优
+        state.bidirectional.reset();
+        state.search.setHeuristicWeight(state.algorithm == Algorithm::AStar ? heuristicWeight : 1.0);
+        state.search.setComponentIndex(components);
+        state.landmarks = state.algorithm == Algorithm::AStar ? landmarks : nullptr;
+        state.search.setLandmarks(state.landmarks.get());
+        state.search.begin(*map, start, goal, state.algorithm);
+    }
     
+    // 记录初始状态（第 0 步总是关键帧）
+    recordStep(state);
+}
+
+void Pathfinder::initializeGrids() {
     // 完全重置所有状态
-    m_dijkstraState = AlgorithmState([](Cell* a, Cell* b) { return a->g > b->g; });
-    m_greedyState = AlgorithmState([](Cell* a, Cell* b) { return a->h > b->h; });
-    m_aStarState = AlgorithmState([](Cell* a, Cell* b) { return a->f > b->f; });
+    for (int i = 0; i < 4; ++i) {
+        m_modelSteps[i] = -1;
+    }
+    m_dijkstraState = AlgorithmState(Algorithm::Dijkstra);
+    m_greedyState = AlgorithmState(Algorithm::Greedy);
+    m_aStarState = AlgorithmState(Algorithm::AStar);
+    m_jumpPointState = AlgorithmState(Algorithm::JumpPoint);
     
-    m_dijkstraState.grid.resize(m_gridSize);
-    m_greedyState.grid.resize(m_gridSize);
-    m_aStarState.grid.resize(m_gridSize);
+    // 设置起点
+    auto map = std::make_shared<const GridMap>(m_map);
+    GridPoint start{m_start.x(), m_start.y()};
+    GridPoint goal{m_end.x(), m_end.y()};
+    initializeState(m_dijkstraState, map, start, goal, m_heuristicWeight, m_bidirectionalMode);
+    initializeState(m_greedyState, map, start, goal, m_heuristicWeight, m_bidirectionalMode);
+    initializeState(m_aStarState, map, start, goal, m_heuristicWeight, m_bidirectionalMode);
+    initializeState(m_jumpPointState, map, start, goal, m_heuristicWeight, m_bidirectionalMode);
+}
+
+const Pathfinder::AlgorithmState &Pathfinder::stateFor(Algorithm algorithm) const {
+    return const_cast<Pathfinder *>(this)->stateFor(algorithm);
+}
+
+Pathfinder::AlgorithmState &Pathfinder::stateFor(Algorithm algorithm) {
+    switch (algorithm) {
+    case Algorithm::Dijkstra: return m_dijkstraState;
+    case Algorithm::Greedy: return m_greedyState;
+    case Algorithm::JumpPoint: return m_jumpPointState;
+    case Algorithm::AStar: break;
+    }
+    return m_aStarState;
+}
+
+void Pathfinder::recomputeAllAlgorithms(int keepProgress) {
+    // 作废仍在运行的旧任务，它们的结果不会再被采用
+    if (m_cancelToken) {
+        m_cancelToken->store(true);
+    }
+    m_cancelToken = std::make_shared<std::atomic<bool>>(false);
+    int generation = ++m_generation;
     
-    for (int y = 0; y < m_gridSize; ++y) {
-        m_dijkstraState.grid[y].resize(m_gridSize);
-        m_greedyState.grid[y].resize(m_gridSize);
-        m_aStarState.grid[y].resize(m_gridSize);
-        
-        for (int x = 0; x < m_gridSize; ++x) {
-            bool isObstacle = m_obstacles[y][x];
-            
-            // 完全重置所有单元格
-            m_dijkstraState.grid[y][x] = Cell();
-            m_dijkstraState.grid[y][x].x = x;
-            m_dijkstraState.grid[y][x].y = y;
-            m_dijkstraState.grid[y][x].isObstacle = isObstacle;
-            m_dijkstraState.grid[y][x].g = INT_MAX;
-            m_dijkstraState.grid[y][x].h = 0;
-            m_dijkstraState.grid[y][x].f = INT_MAX;
-            m_dijkstraState.grid[y][x].isOpen = false;
-            m_dijkstraState.grid[y][x].isClosed = false;
-            m_dijkstraState.grid[y][x].parent = nullptr;
-            
-            m_greedyState.grid[y][x] = Cell();
-            m_greedyState.grid[y][x].x = x;
-            m_greedyState.grid[y][x].y = y;
-            m_greedyState.grid[y][x].isObstacle = isObstacle;
-            m_greedyState.grid[y][x].g = INT_MAX;
-            m_greedyState.grid[y][x].h = 0;
-            m_greedyState.grid[y][x].f = INT_MAX;
-            m_greedyState.grid[y][x].isOpen = false;
-            m_greedyState.grid[y][x].isClosed = false;
-            m_greedyState.grid[y][x].parent = nullptr;
-            
-            m_aStarState.grid[y][x] = Cell();
-            m_aStarState.grid[y][x].x = x;
-            m_aStarState.grid[y][x].y = y;
-            m_aStarState.grid[y][x].isObstacle = isObstacle;
-            m_aStarState.grid[y][x].g = INT_MAX;
-            m_aStarState.grid[y][x].h = 0;
-            m_aStarState.grid[y][x].f = INT_MAX;
-            m_aStarState.grid[y][x].isOpen = false;
-            m_aStarState.grid[y][x].isClosed = false;
-            m_aStarState.grid[y][x].parent = nullptr;
+    m_pendingProgress = keepProgress;
+    m_needsRecomputation = false;
+    
+    // 网格尺寸变化时旧结果无法显示，先同步放上第 0 步；否则保留旧结果直到新结果到达
+    if (!m_dijkstraState.map || m_dijkstraState.map->width() != m_gridSize) {
+        initializeGrids();
+        m_maxProgress = 0;
+        m_progress = 0;
+        emit maxProgressChanged();
+        emit progressChanged();
+        emit gridChanged();
+    }
+    
+    // 工作线程只读取地图快照，GUI 线程可以继续编辑 m_map
+    auto map = std::make_shared<const GridMap>(m_map);
+    GridPoint start{m_start.x(), m_start.y()};
+    GridPoint goal{m_end.x(), m_end.y()};
+    std::shared_ptr<std::atomic<bool>> cancelled = m_cancelToken;
+    double heuristicWeight = m_heuristicWeight;
+    bool bidirectional = m_bidirectionalMode;
+    
+    bool wasComputing = isComputing();
+    
+    // 起点和终点不连通：不必搜索，每个算法只记录第 0 步就以无路径结束
+    if (!m_components.connected(start, goal)) {
+        m_pendingResults = 0;
+        for (Algorithm algorithm : { Algorithm::Dijkstra, Algorithm::Greedy, Algorithm::AStar, Algorithm::JumpPoint }) {
+            AlgorithmState unreachable(algorithm);
+            initializeState(unreachable, map, start, goal, heuristicWeight, bidirectional, nullptr, &m_components);
+            installAlgorithmResult(unreachable);
+        }
+        if (wasComputing) {
+            emit isComputingChanged();
         }
+        return;
     }
     
-    // 清空开放集合
-    while (!m_dijkstraState.openSet.empty()) m_dijkstraState.openSet.pop();
-    while (!m_greedyState.openSet.empty()) m_greedyState.openSet.pop();
-    while (!m_aStarState.openSet.empty()) m_aStarState.openSet.pop();
-    
-    // 清空路径和步骤
-    m_dijkstraState.finalPath.clear();
-    m_dijkstraState.stepGrids.clear();
-    m_dijkstraState.stepPaths.clear();
-    m_dijkstraState.stepFinalPaths.clear();
-    m_greedyState.finalPath.clear();
-    m_greedyState.stepGrids.clear();
-    m_greedyState.stepPaths.clear();
-    m_greedyState.stepFinalPaths.clear();
-    m_aStarState.finalPath.clear();
-    m_aStarState.stepGrids.clear();
-    m_aStarState.stepPaths.clear();
-    m_aStarState.stepFinalPaths.clear();
-    
-    m_dijkstraState.finished = false;
-    m_greedyState.finished = false;
-    m_aStarState.finished = false;
+    // 算过的组合直接从缓存换上，只有未命中的算法交给工作线程
+    QVector<Algorithm> pending;
+    for (Algorithm algorithm : { Algorithm::Dijkstra, Algorithm::Greedy, Algorithm::AStar, Algorithm::JumpPoint }) {
+        PathKey key = resultKey(algorithm, start, goal);
+        std::shared_ptr<const CachedRun> cached = m_resultCache.find(key);
+        if (!cached) {
+            pending.append(algorithm);
+            continue;
+        }
+        
+        AlgorithmState restored(algorithm);
+        restored.map = map;
+        restored.cacheKey = key;
+        restored.history = cached->history;
+        restored.finalPath = cached->finalPath;
+        restored.finalPathMask = cached->finalPathMask;
+        restored.finished = cached->finished;
+        restored.timing = cached->metrics;
+        installAlgorithmResult(restored);
+    }
+    m_pendingResults = pending.size();
     
-    // 设置起点
-    Cell* startCell = getCell(m_dijkstraState.grid, m_start.x(), m_start.y());
-    if (startCell && !startCell->isObstacle) {
-        startCell->g = 0;
-        startCell->h = heuristic(startCell->x, startCell->y, m_end.x(), m_end.y());
-        startCell->f = startCell->g + startCell->h;
-        startCell->isOpen = true;
-        m_dijkstraState.openSet.push(startCell);
-        std::cout << "Dijkstra start cell initialized at (" << m_start.x() << "," << m_start.y() << ")" << std::endl;
-    }
-    
-    startCell = getCell(m_greedyState.grid, m_start.x(), m_start.y());
-    if (startCell && !startCell->isObstacle) {
-        startCell->g = 0;
-        startCell->h = heuristic(startCell->x, startCell->y, m_end.x(), m_end.y());
-        startCell->f = startCell->g + startCell->h;
-        startCell->isOpen = true;
-        m_greedyState.openSet.push(startCell);
-        std::cout << "Greedy start cell initialized at (" << m_start.x() << "," << m_start.y() << ")" << std::endl;
-    }
-    
-    startCell = getCell(m_aStarState.grid, m_start.x(), m_start.y());
-    if (startCell && !startCell->isObstacle) {
-        startCell->g = 0;
-        startCell->h = heuristic(startCell->x, startCell->y, m_end.x(), m_end.y());
-        startCell->f = startCell->g + startCell->h;
-        startCell->isOpen = true;
-        m_aStarState.openSet.push(startCell);
-        std::cout << "A* start cell initialized at (" << m_start.x() << "," << m_start.y() << ")" << std::endl;
-    }
-    
-    // 记录初始状态
-    m_dijkstraState.stepGrids.append(deepCopyGrid(m_dijkstraState.grid));
-    m_greedyState.stepGrids.append(deepCopyGrid(m_greedyState.grid));
-    m_aStarState.stepGrids.append(deepCopyGrid(m_aStarState.grid));
-    
-    std::cout << "All grids initialized. Initial steps recorded." << std::endl;
-    std::cout << "Dijkstra open set size: " << m_dijkstraState.openSet.size() << std::endl;
-    std::cout << "Greedy open set size: " << m_greedyState.openSet.size() << std::endl;
-    std::cout << "A* open set size: " << m_aStarState.openSet.size() << std::endl;
-}
-
-void Pathfinder::recomputeAllAlgorithms() {
-    std::cout << "\n*** RECOMPUTING ALL ALGORITHMS ***" << std::endl;
+    // 单向 A* 使用地标表；地图变过就由 A* 的任务重新构建，构建期间其余面板照常计算
+    bool useLandmarks = m_landmarkMode && !bidirectional;
+    std::shared_ptr<const LandmarkTable> landmarks;
+    if (useLandmarks && m_landmarks && m_landmarkHash == m_map.contentHash()) {
+        landmarks = m_landmarks;
+    }
     
-    // 完全重置所有状态
-    initializeGrids();
+    for (Algorithm algorithm : pending) {
+        PathKey key = resultKey(algorithm, start, goal);
+        m_workerPool.start([this, map, start, goal, algorithm, key, generation, cancelled, heuristicWeight, bidirectional,
+                            useLandmarks, landmarks]() {
+            auto result = std::make_shared<AlgorithmState>(algorithm);
+            result->cacheKey = key;
+            result->search = takeSpareContext();
+            std::shared_ptr<const LandmarkTable> table = landmarks;
+            if (useLandmarks && algorithm == Algorithm::AStar && !table) {
+                // 地图上没有可走格时建不出地标，本次按普通 A* 计算
+                auto built = std::make_shared<LandmarkTable>();
+                if (built->build(*map, kLandmarkCount)) {
+                    table = built;
+                }
+            }
+            initializeState(*result, map, start, goal, heuristicWeight, bidirectional, table);
+            computeAlgorithm(*result, *cancelled);
+            if (cancelled->load()) {
+                return;
+            }
+            
+            // 回到 GUI 线程替换结果
+            QMetaObject::invokeMethod(this, [this, generation, result]() {
+                applyAlgorithmResult(generation, result);
+            }, Qt::QueuedConnection);
+        });
+    }
     
-    std::cout << "Computing Dijkstra..." << std::endl;
-    computeAlgorithm(m_dijkstraState, [](int, int, int, int) { return 0; }, true);
+    if (wasComputing != isComputing()) {
+        emit isComputingChanged();
+    }
+}
+
+PathKey Pathfinder::resultKey(Algorithm algorithm, GridPoint start, GridPoint goal) const {
+    PathKey key;
+    key.mapHash = m_map.contentHash();
+    key.width = m_map.width();
+    key.height = m_map.height();
+    key.start = start;
+    key.goal = goal;
+    key.algorithm = algorithm;
+    // 与 initializeState 一致：双向模式只影响 Dijkstra 和 A*，启发权重只影响单向的 A*
+    bool bidirectional = m_bidirectionalMode && (algorithm == Algorithm::Dijkstra || algorithm == Algorithm::AStar);
+    if (bidirectional) {
+        key.variant = 1;
+    } else if (algorithm == Algorithm::AStar) {
+        key.variant = uint32_t(qRound(m_heuristicWeight * 1000)) << 2 | (m_landmarkMode ? 2 : 0);
+    }
+    return key;
+}
+
+size_t Pathfinder::CachedRun::memoryBytes(int cellCount) const {
+    size_t gridBytes = size_t(cellCount) * (4 * sizeof(int) + sizeof(uint8_t));
+    return sizeof(CachedRun)
+         + size_t(history.keyframes.size()) * gridBytes
+         + size_t(history.deltas.size()) * sizeof(StepHistory::CellDelta)
+         + size_t(history.stepOffsets.size() + history.keyframeSteps.size()) * sizeof(int)
+         + size_t(finalPath.size()) * sizeof(QPoint)
+         + size_t(finalPathMask.size()) * sizeof(quint64);
+}
+
+void Pathfinder::applyAlgorithmResult(int generation, const std::shared_ptr<AlgorithmState> &result) {
+    // 期间又发生了编辑，这个结果已经过期
+    if (generation != m_generation) {
+        return;
+    }
     
-    std::cout << "Computing Greedy..." << std::endl;
-    computeAlgorithm(m_greedyState, [this](int x1, int y1, int x2, int y2) { 
-        return heuristic(x1, y1, x2, y2); 
-    }, false);
+    // 只缓存跑完的计算；达到步数上限而中止的结果不完整
+    if (result->status() != SearchContextBase::Running) {
+        auto run = std::make_shared<CachedRun>();
+        run->history = result->history;
+        run->history.cachedGrid = SearchGrid();
+        run->history.cachedStep = -1;
+        run->finalPath = result->finalPath;
+        run->finalPathMask = result->finalPathMask;
+        run->finished = result->finished;
+        run->metrics = result->metrics();
+        size_t bytes = run->memoryBytes(result->map->cellCount());
+        m_resultCache.insert(result->cacheKey, std::move(run), bytes);
+    }
     
-    std::cout << "Computing A*..." << std::endl;
-    computeAlgorithm(m_aStarState, [this](int x1, int y1, int x2, int y2) { 
-        return heuristic(x1, y1, x2, y2); 
-    }, true);
+    // 留下 A* 任务构建的地标表，地图不变时下次直接使用
+    if (result->landmarks && result->landmarks != m_landmarks) {
+        m_landmarks = result->landmarks;
+        m_landmarkHash = result->cacheKey.mapHash;
+    }
     
-    // 修复：更新最大进度 - 使用三个算法中最大的步骤数
-    int dijkstraSteps = m_dijkstraState.stepGrids.size();
-    int greedySteps = m_greedyState.stepGrids.size();
-    int aStarSteps = m_aStarState.stepGrids.size();
+    installAlgorithmResult(*result);
     
-    m_maxProgress = qMax(dijkstraSteps, qMax(greedySteps, aStarSteps)) - 1;
-    if (m_maxProgress < 0) m_maxProgress = 0;
+    if (--m_pendingResults == 0) {
+        emit isComputingChanged();
+    }
+}
+
+void Pathfinder::installAlgorithmResult(AlgorithmState &result) {
+    AlgorithmState &state = stateFor(result.algorithm);
+    if (state.map) {
+        std::lock_guard<std::mutex> lock(m_spareMutex);
+        if (m_spareContexts.size() < 4) {
+            m_spareContexts.push_back(std::move(state.search));
+        }
+    }
+    state = std::move(result);
+    m_modelSteps[int(state.algorithm)] = -1;
     
-    // 修复：重新计算后总是重置进度为0
-    m_progress = 0;
+    // 修复：更新最大进度 - 使用所有算法中最大的步骤数
+    int dijkstraSteps = m_dijkstraState.history.stepCount();
+    int greedySteps = m_greedyState.history.stepCount();
+    int aStarSteps = m_aStarState.history.stepCount();
+    int jumpPointSteps = m_jumpPointState.history.stepCount();
     
-    // 重置需要重新计算的标志
-    m_needsRecomputation = false;
+    m_maxProgress = qMax(qMax(dijkstraSteps, greedySteps), qMax(aStarSteps, jumpPointSteps)) - 1;
+    if (m_maxProgress < 0) m_maxProgress = 0;
     
-    std::cout << "Recomputation finished." << std::endl;
-    std::cout << "Dijkstra steps: " << dijkstraSteps << std::endl;
-    std::cout << "Greedy steps: " << greedySteps << std::endl;
-    std::cout << "A* steps: " << aStarSteps << std::endl;
-    std::cout << "Max progress: " << m_maxProgress << std::endl;
-    std::cout << "Current progress: " << m_progress << std::endl;
+    // 恢复编辑前的进度，超出新的最大进度时跳到最后一步
+    m_progress = qMin(m_pendingProgress, m_maxProgress);
     
     emit maxProgressChanged();
     emit progressChanged();
     emit gridChanged();
 }
 
-void Pathfinder::computeAlgorithm(AlgorithmState& state, const std::function<int(int, int, int, int)>& heuristicFunc, bool useG) {
-    std::cout << "=== ENTERING computeAlgorithm ===" << std::endl;
-    std::cout << "Algorithm type: " << (useG ? (heuristicFunc(0,0,0,0)==0 ? "Dijkstra" : "A*") : "Greedy") << std::endl;
-    
+SearchContext Pathfinder::takeSpareContext() {
+    std::lock_guard<std::mutex> lock(m_spareMutex);
+    if (m_spareContexts.empty()) {
+        return SearchContext();
+    }
+    SearchContext context = std::move(m_spareContexts.back());
+    m_spareContexts.pop_back();
+    return context;
+}
+
+void Pathfinder::computeAlgorithm(AlgorithmState& state, const std::atomic<bool> &cancelled) {
     // 修复：使用合理的最大步数
-    int maxSteps = m_gridSize * m_gridSize * 2;  // 增加最大步数限制
+    int maxSteps = state.map->cellCount() * 2;  // 增加最大步数限制
     int stepCount = 0;
-    
-    // 主要算法循环
-    while (!state.openSet.empty() && !state.finished && stepCount < maxSteps) {
+    DirtyRecorder recorder{state.dirtyCells};
+    
+    // 主要算法循环；用户再次编辑时提前退出
+    while (!state.finished && stepCount < maxSteps && !cancelled.load(std::memory_order_relaxed)) {
+        SearchContext::Status status;
+        {
+            PhaseTimer timer(state.timing, SearchMetrics::Search);
+            status = state.step(recorder);
+        }
+        if (status == SearchContext::Exhausted) {
+            break;
+        }
         stepCount++;
         
-        Cell* current = state.openSet.top();
-        state.openSet.pop();
-        
-        // 将当前节点标记为已关闭
-        current->isOpen = false;
-        current->isClosed = true;
-        
         // 如果到达终点
-        if (current->x == m_end.x() && current->y == m_end.y()) {
-            std::cout << "*** FOUND PATH TO END! ***" << std::endl;
-            reconstructPath(state, current);
+        if (status == SearchContext::Found) {
+            reconstructPath(state);
             state.finished = true;
             
             // 记录最终状态
-            state.stepGrids.append(deepCopyGrid(state.grid));
-            std::cout << "Final state recorded at step " << state.stepGrids.size() << std::endl;
+            recordStep(state);
             break;
         }
         
-        // 检查相邻节点
-        for (int dx = -1; dx <= 1; dx++) {
-            for (int dy = -1; dy <= 1; dy++) {
-                if (dx != 0 && dy != 0) continue; // 禁止对角线
-                if (dx == 0 && dy == 0) continue;
-                
-                int nx = current->x + dx;
-                int ny = current->y + dy;
-                
-                if (nx < 0 || nx >= m_gridSize || ny < 0 || ny >= m_gridSize) continue;
-                
-                Cell* neighbor = getCell(state.grid, nx, ny);
-                if (!neighbor) continue;
-                
-                // 跳过障碍物和已关闭的节点
-                if (neighbor->isObstacle || neighbor->isClosed) {
-                    continue;
-                }
-                
-                // 计算新的g值
-                int tentativeG = current->g + 1;
-                
-                // 如果新路径更好，更新邻居节点
-                if (tentativeG < neighbor->g) {
-                    neighbor->parent = current;
-                    neighbor->g = tentativeG;
-                    neighbor->h = heuristicFunc(neighbor->x, neighbor->y, m_end.x(), m_end.y());
-                    neighbor->f = useG ? neighbor->g + neighbor->h : neighbor->h;
-                    
-                    if (!neighbor->isOpen) {
-                        neighbor->isOpen = true;
-                        state.openSet.push(neighbor);
-                    }
-                }
-            }
-        }
-        
         // 记录当前步骤状态
-        state.stepGrids.append(deepCopyGrid(state.grid));
+        recordStep(state);
     }
     
     // 如果算法没有找到路径但已经完成，也要确保状态一致
     if (!state.finished) {
-        std::cout << "Algorithm stopped after " << stepCount << " steps without finding path" << std::endl;
         // 如果没有找到路径，也要记录最终状态
-        state.stepGrids.append(deepCopyGrid(state.grid));
+        recordStep(state);
     }
-    
-    std::cout << "Total recorded steps: " << state.stepGrids.size() << std::endl;
 }
 
-bool Pathfinder::stepAlgorithm(AlgorithmState& state, const std::function<int(int, int, int, int)>& heuristicFunc, bool useG) {
-    if (state.finished || state.openSet.empty()) {
+bool Pathfinder::stepAlgorithm(AlgorithmState& state) {
+    if (state.finished || state.status() != SearchContext::Running) {
         return false;
     }
     
-    // 从开放集合中获取下一个单元格
-    Cell* current = state.openSet.top();
-    state.openSet.pop();
-    
-    std::cout << "Processing cell (" << current->x << "," << current->y << ") g=" << current->g << std::endl;
-    
-    // 将当前节点标记为已关闭
-    current->isOpen = false;
-    current->isClosed = true;
+    DirtyRecorder recorder{state.dirtyCells};
+    SearchContext::Status status;
+    {
+        PhaseTimer timer(state.timing, SearchMetrics::Search);
+        status = state.step(recorder);
+    }
+    if (status == SearchContext::Exhausted) {
+        return false;
+    }
     
     // 如果到达终点
-    if (current->x == m_end.x() && current->y == m_end.y()) {
-        std::cout << "*** FOUND PATH TO END! ***" << std::endl;
-        reconstructPath(state, current);
+    if (status == SearchContext::Found) {
+        reconstructPath(state);
         state.finished = true;
         
-        // 记录最终状态
-        state.stepGrids.append(deepCopyGrid(state.grid));
-        return true;
-    }
-    
-    // 检查邻居
-    for (int dx = -1; dx <= 1; dx++) {
-        for (int dy = -1; dy <= 1; dy++) {
-            if (dx != 0 && dy != 0) continue; // 禁止对角线
-            if (dx == 0 && dy == 0) continue;
-            
-            int nx = current->x + dx;
-            int ny = current->y + dy;
-            
-            if (nx < 0 || nx >= m_gridSize || ny < 0 || ny >= m_gridSize) continue;
-            
-            Cell* neighbor = getCell(state.grid, nx, ny);
-            if (!neighbor) continue;
-            
-            // 跳过障碍物和已关闭的节点
-            if (neighbor->isObstacle || neighbor->isClosed) {
-                continue;
-            }
-            
-            // 计算新的g值
-            int tentativeG = current->g + 1;
-            
-            // 如果新路径更好，更新邻居节点
-            if (tentativeG < neighbor->g) {
-                neighbor->parent = current;
-                neighbor->g = tentativeG;
-                neighbor->h = heuristicFunc(neighbor->x, neighbor->y, m_end.x(), m_end.y());
-                neighbor->f = useG ? neighbor->g + neighbor->h : neighbor->h;
-                
-                if (!neighbor->isOpen) {
-                    neighbor->isOpen = true;
-                    state.openSet.push(neighbor);
-                }
-            }
-        }
+        // 立即发射信号更新显示
+        emit gridChanged();
     }
     
     // 记录当前步骤状态
-    state.stepGrids.append(deepCopyGrid(state.grid));
+    recordStep(state);
     
     return true;
 }
 
-int Pathfinder::heuristic(int x1, int y1, int x2, int y2) {
-    return qAbs(x1 - x2) + qAbs(y1 - y2);
+// 修改：重构路径函数，确保在找到终点时立即保存最终路径
+void Pathfinder::reconstructPath(AlgorithmState &state) {
+    PhaseTimer timer(state.timing, SearchMetrics::Reconstruct);
+    std::vector<GridPoint> path = state.path();
+    state.finalPath.clear();
+    state.finalPath.reserve(int(path.size()));
+    state.finalPathMask.fill(0, (state.map->cellCount() + 63) / 64);
+    for (const GridPoint &point : path) {
+        state.finalPath.append(QPoint(point.x, point.y));
+        int index = state.map->index(point.x, point.y);
+        state.finalPathMask[index >> 6] |= quint64(1) << (index & 63);
+    }
 }
 
-// 修改：重构路径函数，确保在找到终点时立即保存最终路径
-void Pathfinder::reconstructPath(AlgorithmState &state, Cell *current) {
-    // 如果是到达终点，保存最终路径
-    if (current->x == m_end.x() && current->y == m_end.y()) {
-        state.finalPath.clear();
-        Cell* temp = current;
-        while (temp) {
-            state.finalPath.prepend(QPoint(temp->x, temp->y));
-            temp = temp->parent;
+bool Pathfinder::isOnFinalPath(const AlgorithmState &state, int index) {
+    return (index >> 6) < state.finalPathMask.size() && ((state.finalPathMask[index >> 6] >> (index & 63)) & 1);
+}
+
+GridCellModel::Cell Pathfinder::packCell(const AlgorithmState &state, const SearchGrid *grid, int index, bool showFinalPath) const {
+    const quint16 unreached = 0xFFFF;
+    GridCellModel::Cell cell;
+    if (m_map.isObstacle(index)) cell.flags |= CellObstacle;
+    if (!grid) {
+        return cell;
+    }
+    
+    if (grid->isOpen(index)) cell.flags |= CellOpen;
+    if (grid->isClosed(index)) cell.flags |= CellClosed;
+    if (showFinalPath && isOnFinalPath(state, index)) cell.flags |= CellFinalPath;
+    cell.g = grid->g[index] >= unreached ? unreached : quint16(grid->g[index]);
+    cell.h = quint16(qMin(grid->h[index], int(unreached)));
+    cell.f = grid->f[index] >= unreached ? unreached : quint16(grid->f[index]);
+    return cell;
+}
+
+QByteArray Pathfinder::cellSnapshot(int algorithm) const {
+    if (algorithm < int(Algorithm::Dijkstra) || algorithm > int(Algorithm::JumpPoint)) {
+        return QByteArray();
+    }
+    
+    const AlgorithmState &state = stateFor(Algorithm(algorithm));
+    const int cellCount = m_gridSize * m_gridSize;
+    
+    QByteArray bytes(cellCount * 4 * int(sizeof(quint16)), Qt::Uninitialized);
+    quint16 *out = reinterpret_cast<quint16 *>(bytes.data());
+    
+    int stepCount = state.history.stepCount();
+    const SearchGrid *grid = nullptr;
+    bool showFinalPath = false;
+    if (stepCount > 0 && state.map && state.map->cellCount() == cellCount) {
+        int displayProgress = qMin(m_progress, stepCount - 1);
+        grid = &state.history.gridAt(displayProgress);
+        showFinalPath = state.finished && displayProgress == stepCount - 1;
+    }
+    
+    for (int i = 0; i < cellCount; ++i) {
+        GridCellModel::Cell cell = packCell(state, grid, i, showFinalPath);
+        out[i * 4] = cell.flags;
+        out[i * 4 + 1] = cell.g;
+        out[i * 4 + 2] = cell.h;
+        out[i * 4 + 3] = cell.f;
+    }
+    return bytes;
+}
+
+// 进度变化时只比较两步之间增量涉及的单元格；结果整体替换或跨度太大时才逐格比较
+void Pathfinder::refreshCellModels(const QVector<int> &extraCells) {
+    const int cellCount = m_gridSize * m_gridSize;
+    
+    for (Algorithm algorithm : { Algorithm::Dijkstra, Algorithm::Greedy, Algorithm::AStar, Algorithm::JumpPoint }) {
+        const AlgorithmState &state = stateFor(algorithm);
+        int slot = int(algorithm);
+        GridCellModel *model = m_cellModels[slot];
+        
+        int stepCount = state.history.stepCount();
+        bool hasHistory = stepCount > 0 && state.map && state.map->cellCount() == cellCount;
+        int step = hasHistory ? qMin(m_progress, stepCount - 1) : -1;
+        bool showFinalPath = hasHistory && state.finished && step == stepCount - 1;
+        const SearchGrid *grid = hasHistory ? &state.history.gridAt(step) : nullptr;
+        
+        QVector<int> indices = extraCells;
+        bool incremental = hasHistory && m_modelSteps[slot] >= 0 && model->gridSize() == m_gridSize
+                           && state.history.collectChangedCells(m_modelSteps[slot], step, cellCount, indices);
+        
+        if (incremental) {
+            if (showFinalPath != m_modelFinalPaths[slot]) {
+                for (const QPoint &point : state.finalPath) {
+                    indices.append(point.y() * m_gridSize + point.x());
+                }
+            }
+            
+            QVector<GridCellModel::Cell> cells;
+            cells.reserve(indices.size());
+            for (int index : indices) {
+                cells.append(packCell(state, grid, index, showFinalPath));
+            }
+            model->updateCells(indices, cells);
+        } else {
+            QVector<GridCellModel::Cell> cells(cellCount);
+            for (int i = 0; i < cellCount; ++i) {
+                cells[i] = packCell(state, grid, i, showFinalPath);
+            }
+            model->setCells(m_gridSize, cells);
         }
-        std::cout << "Final path reconstructed, length: " << state.finalPath.size() << std::endl;
         
-        // 立即发射信号更新显示
-        emit gridChanged();
+        m_modelSteps[slot] = step;
+        m_modelFinalPaths[slot] = showFinalPath;
     }
 }
 
 // 简化：只保留最终路径参数
-QVariantMap Pathfinder::cellToVariantMap(const Cell& cell, bool inFinalPath) const {
+QVariantMap Pathfinder::cellToVariantMap(const SearchGrid& grid, int index, bool inFinalPath) const {
     QVariantMap cellData;
-    cellData["x"] = cell.x;
-    cellData["y"] = cell.y;
-    cellData["isObstacle"] = cell.isObstacle;
-    cellData["g"] = cell.g == INT_MAX ? 999 : cell.g;
-    cellData["h"] = cell.h;
-    cellData["f"] = cell.f == INT_MAX ? 999 : cell.f;
-    cellData["isOpen"] = cell.isOpen;
-    cellData["isClosed"] = cell.isClosed;
+    cellData["x"] = grid.xOf(index);
+    cellData["y"] = grid.yOf(index);
+    cellData["isObstacle"] = m_map.isObstacle(index);
+    cellData["g"] = grid.g[index] == SearchGrid::Unreached ? 999 : grid.g[index];
+    cellData["h"] = grid.h[index];
+    cellData["f"] = grid.f[index] == SearchGrid::Unreached ? 999 : grid.f[index];
+    cellData["isOpen"] = grid.isOpen(index);
+    cellData["isClosed"] = grid.isClosed(index);
     cellData["isFinalPath"] = inFinalPath;  // 只保留最终路径
     return cellData;
 }
@@ -779,23 +1282,16 @@ QVariantMap Pathfinder::getDijkstraCell(int x, int y) const {
     }
     
     // 修复：始终显示当前进度的状态，而不是最终状态
-    int displayProgress = qMin(m_progress, m_dijkstraState.stepGrids.size() - 1);
+    int displayProgress = qMin(m_progress, m_dijkstraState.history.stepCount() - 1);
     
-    if (displayProgress >= 0 && displayProgress < m_dijkstraState.stepGrids.size()) {
-        const auto& grid = m_dijkstraState.stepGrids[displayProgress];
+    if (displayProgress >= 0 && displayProgress < m_dijkstraState.history.stepCount()) {
+        const auto& grid = m_dijkstraState.history.gridAt(displayProgress);
         
         // 检查是否在最终路径中 - 只有在算法完成且是最后一步时才显示
-        bool inFinalPath = false;
-        if (m_dijkstraState.finished && displayProgress == (m_dijkstraState.stepGrids.size() - 1)) {
-            for (const QPoint &p : m_dijkstraState.finalPath) {
-                if (p.x() == x && p.y() == y) {
-                    inFinalPath = true;
-                    break;
-                }
-            }
-        }
+        bool inFinalPath = m_dijkstraState.finished && displayProgress == (m_dijkstraState.history.stepCount() - 1)
+                           && isOnFinalPath(m_dijkstraState, grid.index(x, y));
         
-        return cellToVariantMap(grid[y][x], inFinalPath);
+        return cellToVariantMap(grid, grid.index(x, y), inFinalPath);
     }
     
     // 默认数据
@@ -809,22 +1305,15 @@ QVariantMap Pathfinder::getGreedyCell(int x, int y) const {
     }
     
     // 修复：始终显示当前进度的状态
-    int displayProgress = qMin(m_progress, m_greedyState.stepGrids.size() - 1);
+    int displayProgress = qMin(m_progress, m_greedyState.history.stepCount() - 1);
     
-    if (displayProgress >= 0 && displayProgress < m_greedyState.stepGrids.size()) {
-        const auto& grid = m_greedyState.stepGrids[displayProgress];
+    if (displayProgress >= 0 && displayProgress < m_greedyState.history.stepCount()) {
+        const auto& grid = m_greedyState.history.gridAt(displayProgress);
         
-        bool inFinalPath = false;
-        if (m_greedyState.finished && displayProgress == (m_greedyState.stepGrids.size() - 1)) {
-            for (const QPoint &p : m_greedyState.finalPath) {
-                if (p.x() == x && p.y() == y) {
-                    inFinalPath = true;
-                    break;
-                }
-            }
-        }
+        bool inFinalPath = m_greedyState.finished && displayProgress == (m_greedyState.history.stepCount() - 1)
+                           && isOnFinalPath(m_greedyState, grid.index(x, y));
         
-        return cellToVariantMap(grid[y][x], inFinalPath);
+        return cellToVariantMap(grid, grid.index(x, y), inFinalPath);
     }
     
     return createDefaultCellData(x, y);
@@ -837,22 +1326,35 @@ QVariantMap Pathfinder::getAStarCell(int x, int y) const {
     }
     
     // 修复：始终显示当前进度的状态
-    int displayProgress = qMin(m_progress, m_aStarState.stepGrids.size() - 1);
+    int displayProgress = qMin(m_progress, m_aStarState.history.stepCount() - 1);
     
-    if (displayProgress >= 0 && displayProgress < m_aStarState.stepGrids.size()) {
-        const auto& grid = m_aStarState.stepGrids[displayProgress];
+    if (displayProgress >= 0 && displayProgress < m_aStarState.history.stepCount()) {
+        const auto& grid = m_aStarState.history.gridAt(displayProgress);
         
-        bool inFinalPath = false;
-        if (m_aStarState.finished && displayProgress == (m_aStarState.stepGrids.size() - 1)) {
-            for (const QPoint &p : m_aStarState.finalPath) {
-                if (p.x() == x && p.y() == y) {
-                    inFinalPath = true;
-                    break;
-                }
-            }
-        }
+        bool inFinalPath = m_aStarState.finished && displayProgress == (m_aStarState.history.stepCount() - 1)
+                           && isOnFinalPath(m_aStarState, grid.index(x, y));
+        
+        return cellToVariantMap(grid, grid.index(x, y), inFinalPath);
+    }
+    
+    return createDefaultCellData(x, y);
+}
+
+// 跳点搜索只把跳点放进开放/关闭集合，其余格子保持未访问
+QVariantMap Pathfinder::getJumpPointCell(int x, int y) const {
+    if (x < 0 || x >= m_gridSize || y < 0 || y >= m_gridSize) {
+        return QVariantMap();
+    }
+    
+    int displayProgress = qMin(m_progress, m_jumpPointState.history.stepCount() - 1);
+    
+    if (displayProgress >= 0 && displayProgress < m_jumpPointState.history.stepCount()) {
+        const auto& grid = m_jumpPointState.history.gridAt(displayProgress);
         
-        return cellToVariantMap(grid[y][x], inFinalPath);
+        bool inFinalPath = m_jumpPointState.finished && displayProgress == (m_jumpPointState.history.stepCount() - 1)
+                           && isOnFinalPath(m_jumpPointState, grid.index(x, y));
+        
+        return cellToVariantMap(grid, grid.index(x, y), inFinalPath);
     }
     
     return createDefaultCellData(x, y);
@@ -862,7 +1364,7 @@ QVariantMap Pathfinder::createDefaultCellData(int x, int y) const {
     QVariantMap defaultData;
     defaultData["x"] = x;
     defaultData["y"] = y;
-    defaultData["isObstacle"] = m_obstacles[y][x];
+    defaultData["isObstacle"] = m_map.isObstacle(x, y);
     defaultData["g"] = 999;
     defaultData["h"] = 0;
     defaultData["f"] = 999;
@@ -872,33 +1374,60 @@ QVariantMap Pathfinder::createDefaultCellData(int x, int y) const {
     return defaultData;
 }
 
-Pathfinder::Cell* Pathfinder::getCell(QVector<QVector<Pathfinder::Cell>>& grid, int x, int y) {
-    if (x >= 0 && x < m_gridSize && y >= 0 && y < m_gridSize) {
-        return &grid[y][x];
+int Pathfinder::getCell(const SearchGrid& grid, int x, int y) const {
+    if (grid.contains(x, y)) {
+        return grid.index(x, y);
     }
-    return nullptr;
+    return -1;
 }
 
 // 实现 debugStepInfo 方法
 void Pathfinder::debugStepInfo() const {
     std::cout << "\n=== STEP DEBUG INFO ===" << std::endl;
     std::cout << "Current progress: " << m_progress << "/" << m_maxProgress << std::endl;
-    std::cout << "Dijkstra steps: " << m_dijkstraState.stepGrids.size() 
+    std::cout << "Dijkstra steps: " << m_dijkstraState.history.stepCount() 
               << ", finished: " << m_dijkstraState.finished << std::endl;
-    std::cout << "Greedy steps: " << m_greedyState.stepGrids.size() 
+    std::cout << "Greedy steps: " << m_greedyState.history.stepCount() 
               << ", finished: " << m_greedyState.finished << std::endl;
-    std::cout << "A* steps: " << m_aStarState.stepGrids.size() 
+    std::cout << "A* steps: " << m_aStarState.history.stepCount() 
               << ", finished: " << m_aStarState.finished << std::endl;
+    std::cout << "JPS steps: " << m_jumpPointState.history.stepCount() 
+              << ", finished: " << m_jumpPointState.finished << std::endl;
     
     // 检查特定单元格在不同步骤的状态
-    if (m_dijkstraState.stepGrids.size() > 0) {
+    if (m_dijkstraState.history.stepCount() > 0) {
+        const SearchGrid &grid = m_dijkstraState.history.gridAt(0);
+        int startIndex = grid.index(m_start.x(), m_start.y());
         std::cout << "Dijkstra start cell at step 0: " 
-                  << "g=" << m_dijkstraState.stepGrids[0][m_start.y()][m_start.x()].g 
-                  << ", isOpen=" << m_dijkstraState.stepGrids[0][m_start.y()][m_start.x()].isOpen << std::endl;
+                  << "g=" << grid.g[startIndex] 
+                  << ", isOpen=" << grid.isOpen(startIndex) << std::endl;
     }
-    if (m_dijkstraState.stepGrids.size() > m_progress) {
+    if (m_dijkstraState.history.stepCount() > m_progress) {
+        const SearchGrid &grid = m_dijkstraState.history.gridAt(m_progress);
+        int startIndex = grid.index(m_start.x(), m_start.y());
         std::cout << "Dijkstra start cell at current step: " 
-                  << "g=" << m_dijkstraState.stepGrids[m_progress][m_start.y()][m_start.x()].g 
-                  << ", isOpen=" << m_dijkstraState.stepGrids[m_progress][m_start.y()][m_start.x()].isOpen << std::endl;
+                  << "g=" << grid.g[startIndex] 
+                  << ", isOpen=" << grid.isOpen(startIndex) << std::endl;
     }
+}
+
+QVariantMap Pathfinder::stats() const {
+    QVariantMap result;
+    result["enabled"] = SearchMetrics::Enabled;
+    result["dijkstra"] = metricsToVariantMap(m_dijkstraState.metrics());
+    result["greedy"] = metricsToVariantMap(m_greedyState.metrics());
+    result["aStar"] = metricsToVariantMap(m_aStarState.metrics());
+    result["jumpPoint"] = metricsToVariantMap(m_jumpPointState.metrics());
+    if (m_anytimeMode) {
+        result["anytime"] = metricsToVariantMap(m_anytime.result().metrics);
+    }
+    
+    QVariantMap cache;
+    cache["entries"] = qlonglong(m_resultCache.size());
+    cache["bytes"] = qlonglong(m_resultCache.bytes());
+    cache["hits"] = m_resultCache.hits();
+    cache["misses"] = m_resultCache.misses();
+    result["cache"] = cache;
+    result["components"] = m_components.componentCount();
+    return result;
 }
\ No newline at end of file
@@ -6,8 +6,21 @@
 #include <QPoint>
 #include <QTimer>
 #include <QVariantMap>
-#include <queue>
-#include <functional>
+#include <QVariantList>
+#include <QByteArray>
+#include <QUrl>
+#include <QThreadPool>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "pathengine.h"
+#include "pathcache.h"
+#include "incrementalplanner.h"
+#include "hierarchicalpathfinder.h"
+#include "anytimeplanner.h"
+#include "bidirectionalsearch.h"
+#include "gridcellmodel.h"
 
 class Pathfinder : public QObject {
     Q_OBJECT
@@ -17,9 +30,37 @@ class Pathfinder : public QObject {
     Q_PROPERTY(int progress READ progress WRITE setProgress NOTIFY progressChanged)
     Q_PROPERTY(int maxProgress READ maxProgress NOTIFY maxProgressChanged)
     Q_PROPERTY(bool isRunning READ isRunning NOTIFY isRunningChanged)
+    Q_PROPERTY(bool isComputing READ isComputing NOTIFY isComputingChanged)
+    Q_PROPERTY(bool incrementalMode READ incrementalMode WRITE setIncrementalMode NOTIFY incrementalModeChanged)
+    Q_PROPERTY(QVariantList incrementalPath READ incrementalPath NOTIFY incrementalPathChanged)
+    Q_PROPERTY(int incrementalExpanded READ incrementalExpanded NOTIFY incrementalPathChanged)
+    Q_PROPERTY(bool hierarchicalMode READ hierarchicalMode WRITE setHierarchicalMode NOTIFY hierarchicalModeChanged)
+    Q_PROPERTY(QVariantList hierarchicalPath READ hierarchicalPath NOTIFY hierarchicalPathChanged)
+    Q_PROPERTY(int hierarchicalExpanded READ hierarchicalExpanded NOTIFY hierarchicalPathChanged)
+    Q_PROPERTY(double heuristicWeight READ heuristicWeight WRITE setHeuristicWeight NOTIFY heuristicWeightChanged)
+    Q_PROPERTY(bool bidirectionalMode READ bidirectionalMode WRITE setBidirectionalMode NOTIFY bidirectionalModeChanged)
+    Q_PROPERTY(bool landmarkMode READ landmarkMode WRITE setLandmarkMode NOTIFY landmarkModeChanged)
+    Q_PROPERTY(bool anytimeMode READ anytimeMode WRITE setAnytimeMode NOTIFY anytimeModeChanged)
+    Q_PROPERTY(QVariantList anytimePath READ anytimePath NOTIFY anytimePathChanged)
+    Q_PROPERTY(double anytimeBound READ anytimeBound NOTIFY anytimePathChanged)
+    Q_PROPERTY(int anytimeExpanded READ anytimeExpanded NOTIFY anytimePathChanged)
+    Q_PROPERTY(GridCellModel *dijkstraModel READ dijkstraModel CONSTANT)
+    Q_PROPERTY(GridCellModel *greedyModel READ greedyModel CONSTANT)
+    Q_PROPERTY(GridCellModel *aStarModel READ aStarModel CONSTANT)
+    Q_PROPERTY(GridCellModel *jumpPointModel READ jumpPointModel CONSTANT)
 
 public:
+    // cellSnapshot 中每格的标志位
+    enum CellFlag {
+        CellObstacle = 0x1,
+        CellOpen = 0x2,
+        CellClosed = 0x4,
+        CellFinalPath = 0x8
+    };
+    Q_ENUM(CellFlag)
+
     explicit Pathfinder(QObject *parent = nullptr);
+    ~Pathfinder() override;
 
     int gridSize() const;
     void setGridSize(int size);
@@ -36,6 +77,46 @@ public:
     int maxProgress() const;
     
     bool isRunning() const;
+    
+    bool isComputing() const;
+    
+    // 增量规划模式：编辑之间保留搜索状态，只修复受影响的部分
+    bool incrementalMode() const;
+    void setIncrementalMode(bool enabled);
+    QVariantList incrementalPath() const;
+    int incrementalExpanded() const;
+    
+    // 分层寻路模式：在簇抽象图上查询，编辑时只重建受影响的簇
+    bool hierarchicalMode() const;
+    void setHierarchicalMode(bool enabled);
+    QVariantList hierarchicalPath() const;
+    int hierarchicalExpanded() const;
+    
+    // A* 面板的启发权重 ε（加权 A*），1 为标准 A*；路径代价不超过最优值的 ε 倍
+    double heuristicWeight() const;
+    void setHeuristicWeight(double weight);
+    
+    // 双向模式：Dijkstra 和 A* 面板改为从起点和终点同时搜索，两棵搜索树显示在同一张网格上
+    bool bidirectionalMode() const;
+    void setBidirectionalMode(bool enabled);
+    
+    // 地标模式（ALT）：单向 A* 面板的启发值取曼哈顿距离与地标三角不等式下界中较大的一个。
+    // 地标表在 A* 的后台任务里按当前地图构建，地图不变时重复使用
+    bool landmarkMode() const;
+    void setLandmarkMode(bool enabled);
+    
+    // 随时可停模式（ARA*）：编辑后在时间预算内先给出一条路径，之后在空闲时逐步改进
+    bool anytimeMode() const;
+    void setAnytimeMode(bool enabled);
+    QVariantList anytimePath() const;
+    double anytimeBound() const;
+    int anytimeExpanded() const;
+    
+    // 每个算法当前步骤的单元格模型，随进度只刷新变化的单元格
+    GridCellModel *dijkstraModel() const { return m_cellModels[int(Algorithm::Dijkstra)]; }
+    GridCellModel *greedyModel() const { return m_cellModels[int(Algorithm::Greedy)]; }
+    GridCellModel *aStarModel() const { return m_cellModels[int(Algorithm::AStar)]; }
+    GridCellModel *jumpPointModel() const { return m_cellModels[int(Algorithm::JumpPoint)]; }
 
     Q_INVOKABLE void toggleObstacle(int x, int y);
     Q_INVOKABLE void stepForward();
@@ -46,13 +127,29 @@ public:
     Q_INVOKABLE void debugPrintGrids();
     Q_INVOKABLE void clearAllObstacles();
     
+    // 打开地图文件：.gmap 为内存映射的二进制地图（见 mapfile.h），其余按 MovingAI 的 .map 解析。
+    // 非正方形的地图在右侧或下方补障碍物；边长超过界面上限时拒绝打开
+    Q_INVOKABLE bool loadMap(const QUrl &file);
+    Q_INVOKABLE bool saveMap(const QUrl &file) const;
+    
     // 直接获取单元格数据的函数
     Q_INVOKABLE QVariantMap getDijkstraCell(int x, int y) const;
     Q_INVOKABLE QVariantMap getGreedyCell(int x, int y) const;
     Q_INVOKABLE QVariantMap getAStarCell(int x, int y) const;
+    Q_INVOKABLE QVariantMap getJumpPointCell(int x, int y) const;
+    
+    // 一次取出某个算法（0 Dijkstra，1 Greedy，2 A*，3 JPS）当前步骤的全部单元格。
+    // 每格 4 个 quint16，依次为 CellFlag 标志位、g、h、f；未到达的代价为 0xFFFF
+    Q_INVOKABLE QByteArray cellSnapshot(int algorithm) const;
     
     // 添加调试方法
     Q_INVOKABLE void debugStepInfo() const;
+    
+    // 最近一次计算的搜索统计，按面板分组（dijkstra、greedy、aStar、jumpPoint，随时可停模式下还有 anytime）：
+    // 扩展、入队、出队、decrease-key、过期出队次数，开放集合峰值，以及各阶段耗时（毫秒）。
+    // 编译时关闭 ASTAR_METRICS 后计数都为 0，enabled 为 false。cache 为结果缓存的条目数、字节数和命中次数，
+    // components 为当前地图可走格子的连通分量个数
+    Q_INVOKABLE QVariantMap stats() const;
 
 signals:
     void gridSizeChanged();
@@ -61,40 +158,94 @@ signals:
     void progressChanged();
     void maxProgressChanged();
     void isRunningChanged();
+    void isComputingChanged();
+    void incrementalModeChanged();
+    void incrementalPathChanged();
+    void hierarchicalModeChanged();
+    void hierarchicalPathChanged();
+    void heuristicWeightChanged();
+    void bidirectionalModeChanged();
+    void landmarkModeChanged();
+    void anytimeModeChanged();
+    void anytimePathChanged();
     void gridChanged();
 
 private:
-    struct Cell {
-        int x, y;
-        bool isObstacle;
-        int g, h, f;
-        bool isOpen, isClosed;
-        Cell *parent;
-        
-        Cell() : x(0), y(0), isObstacle(false), g(INT_MAX), h(0), f(INT_MAX), 
-                isOpen(false), isClosed(false), parent(nullptr) {}
-        
-        Cell(const Cell& other) 
-            : x(other.x), y(other.y), isObstacle(other.isObstacle), 
-              g(other.g), h(other.h), f(other.f),
-              isOpen(other.isOpen), isClosed(other.isClosed), parent(other.parent) {}
+    // 增量步骤历史：每一步只记录发生变化的单元格，并按增量总量定期保存关键帧。
+    // 任意步骤都可以从最近的关键帧开始回放增量重建出来。
+    struct StepHistory {
+        struct CellDelta {
+            int index;  // y * gridSize + x
+            SearchGrid::CellState state;
+        };
+
+        QVector<SearchGrid> keyframes;
+        QVector<int> keyframeSteps;   // 每个关键帧对应的步骤号（递增）
+        QVector<CellDelta> deltas;    // 所有步骤的增量连续存放
+        QVector<int> stepOffsets;     // 第 i 步的增量在 deltas 中的起始位置
+        int deltasSinceKeyframe = 0;
+
+        // 回放缓存：记住上一次重建的步骤，顺序前进时只需应用新增量
+        mutable SearchGrid cachedGrid;
+        mutable int cachedStep = -1;
+
+        void clear();
+        int stepCount() const { return stepOffsets.size(); }
+        const SearchGrid& gridAt(int step) const;
+        // 把 fromStep 与 toStep 之间（任意方向）被修改过的单元格追加到 out；
+        // 增量总数超过 limit 时返回 false，此时整体比较更划算
+        bool collectChangedCells(int fromStep, int toStep, int limit, QVector<int>& out) const;
+
+    private:
+        void applyDeltas(SearchGrid& grid, int fromStep, int toStep) const;
     };
 
+    // 每个算法的界面状态：搜索本身交给 SearchContext，这里只负责记录步骤供回放
     struct AlgorithmState {
-        QVector<QVector<Cell>> grid;
-        std::priority_queue<Cell*, std::vector<Cell*>, std::function<bool(Cell*, Cell*)>> openSet;
+        Algorithm algorithm;
+        std::shared_ptr<const GridMap> map;   // 计算时的地图快照，search 引用它
+        SearchContext search;
+        std::unique_ptr<BidirectionalSearchContext> bidirectional;  // 双向模式下代替 search，否则为空
         QVector<QPoint> finalPath;  // 最终路径
+        QVector<quint64> finalPathMask;  // 最终路径的位掩码，按单元格索引查询
         bool finished;
         
-        QVector<QVector<QVector<Cell>>> stepGrids;
+        StepHistory history;
+        QVector<int> dirtyCells;                  // 当前步骤中被修改的单元格索引
         QVector<QVector<QPoint>> stepPaths;       // 添加缺失的成员
         QVector<QVector<QPoint>> stepFinalPaths;  // 添加缺失的成员
+        SearchMetrics timing;                     // 界面层计时的阶段：逐步扩展、回溯路径、记录步骤
+        PathKey cacheKey;                         // 计算时的地图散列、起点终点和设置，结果按它放进缓存
+        std::shared_ptr<const LandmarkTable> landmarks;  // search 使用的地标表，由这里保持存活
+        
+        explicit AlgorithmState(Algorithm algorithm = Algorithm::AStar) : 
+            algorithm(algorithm), finished(false) {}
         
-        AlgorithmState(std::function<bool(Cell*, Cell*)> cmp) : 
-            openSet(cmp), finished(false) {}
+        // 以下按当前使用的搜索转发
+        SearchContextBase::Status status() const { return bidirectional ? bidirectional->status() : search.status(); }
+        template <typename Recorder>
+        SearchContextBase::Status step(Recorder &recorder) { return bidirectional ? bidirectional->step(recorder) : search.step(recorder); }
+        SearchGrid::CellState cellState(int index) const { return bidirectional ? bidirectional->cellState(index) : search.grid().cellState(index); }
+        const SearchGrid &grid() const { return bidirectional ? bidirectional->grid() : search.grid(); }
+        std::vector<GridPoint> path() const { return bidirectional ? bidirectional->path() : search.path(); }
+        SearchMetrics metrics() const {
+            SearchMetrics merged = bidirectional ? bidirectional->metrics() : search.metrics();
+            merged.merge(timing);
+            return merged;
+        }
     };
     
-    void computeAlgorithm(AlgorithmState& state, const std::function<int(int, int, int, int)>& heuristicFunc, bool useG);
+    // 缓存的一次完整计算：回放所需的步骤历史和最终路径，不含搜索上下文。
+    // QVector 隐式共享，放进缓存和从缓存换上都不复制历史数据
+    struct CachedRun {
+        StepHistory history;
+        QVector<QPoint> finalPath;
+        QVector<quint64> finalPathMask;
+        bool finished = false;
+        SearchMetrics metrics;
+        
+        size_t memoryBytes(int cellCount) const;
+    };
 
     int m_gridSize;
     QPoint m_start;
@@ -104,27 +255,92 @@ private:
     AlgorithmState m_dijkstraState;
     AlgorithmState m_greedyState;
     AlgorithmState m_aStarState;
+    AlgorithmState m_jumpPointState;
     
     int m_progress;
     int m_maxProgress;
     bool m_isRunning;
     bool m_needsRecomputation;
+    
+    // 后台重新计算：每个算法各一个任务并行执行，编辑后旧任务作废
+    QThreadPool m_workerPool;
+    std::shared_ptr<std::atomic<bool>> m_cancelToken;
+    int m_generation;
+    int m_pendingResults;
+    int m_pendingProgress;
+    
+    // 被新结果替换下来的搜索上下文，留给下一次计算复用：网格和开放集合不再重新分配，
+    // begin() 只清空上次写过的格子。工作线程取、GUI 线程放，用互斥量保护
+    std::mutex m_spareMutex;
+    std::vector<SearchContext> m_spareContexts;
 
-    QVector<QVector<bool>> m_obstacles;
+    GridMap m_map;
+    // m_map 的连通分量，编辑时增量更新；起点终点不连通时所有算法直接以无路径结束
+    ComponentIndex m_components;
+    
+    // 增量规划器在 GUI 线程上同步修复，代价与编辑量成正比
+    IncrementalPlanner m_planner;
+    bool m_incrementalMode;
+    
+    HierarchicalPathfinder m_hierarchical;
+    PathResult m_hierarchicalResult;
+    bool m_hierarchicalMode;
+    
+    double m_heuristicWeight;
+    bool m_bidirectionalMode;
+    
+    // 最近一次构建的地标表及其地图散列，散列与当前地图一致时直接交给 A* 任务
+    bool m_landmarkMode;
+    std::shared_ptr<const LandmarkTable> m_landmarks;
+    uint64_t m_landmarkHash;
+    
+    // 规划器引用 m_map，每次编辑都会重新开始查询
+    AnytimePlanner m_anytime;
+    QTimer *m_anytimeTimer;
+    bool m_anytimeMode;
+    
+    // 按 Algorithm 编号的单元格模型，以及模型当前显示的步骤（-1 表示下次需要整体比较）
+    GridCellModel *m_cellModels[4];
+    int m_modelSteps[4];
+    bool m_modelFinalPaths[4];
+    
+    // 已完成的计算按地图内容、起点终点和算法设置缓存，拖回算过的位置时不再搜索
+    LruCache<CachedRun> m_resultCache;
 
+    // 换上新地图并把起点终点放到给定位置，所有模式重新开始
+    void adoptMap(GridMap map, const QPoint &start, const QPoint &end);
     void initializeGrids();
-    void recomputeAllAlgorithms();
+    void recomputeAllAlgorithms(int keepProgress);
+    void applyAlgorithmResult(int generation, const std::shared_ptr<AlgorithmState> &result);
+    void installAlgorithmResult(AlgorithmState &result);
+    SearchContext takeSpareContext();
+    PathKey resultKey(Algorithm algorithm, GridPoint start, GridPoint goal) const;
+    AlgorithmState &stateFor(Algorithm algorithm);
+    const AlgorithmState &stateFor(Algorithm algorithm) const;
+    void replanIncremental();
+    void rebuildHierarchical();
+    void replanHierarchical();
+    void replanAnytime();
     
-    bool stepAlgorithm(AlgorithmState& state, const std::function<int(int, int, int, int)>& heuristicFunc, bool useG);
+    // 把各模型同步到当前进度；extraCells 是步骤历史之外发生变化的单元格（如刚切换的障碍物）
+    void refreshCellModels(const QVector<int> &extraCells = QVector<int>());
+    GridCellModel::Cell packCell(const AlgorithmState &state, const SearchGrid *grid, int index, bool showFinalPath) const;
     
-    int heuristic(int x1, int y1, int x2, int y2);
-    void reconstructPath(AlgorithmState &state, Cell *current);
-    QVariantMap cellToVariantMap(const Cell& cell, bool inFinalPath) const;  // 简化：只保留最终路径参数
-    Cell* getCell(QVector<QVector<Cell>>& grid, int x, int y);
+    bool stepAlgorithm(AlgorithmState& state);
     
-    QVector<QVector<Cell>> deepCopyGrid(const QVector<QVector<Cell>>& source) const;
+    // 以下静态函数只读写传入的状态，可以在工作线程中运行
+    static void initializeState(AlgorithmState &state, const std::shared_ptr<const GridMap> &map, GridPoint start, GridPoint goal,
+                                double heuristicWeight, bool bidirectional,
+                                const std::shared_ptr<const LandmarkTable> &landmarks = nullptr,
+                                const ComponentIndex *components = nullptr);
+    static void computeAlgorithm(AlgorithmState& state, const std::atomic<bool> &cancelled);
+    static void reconstructPath(AlgorithmState &state);
+    static bool isOnFinalPath(const AlgorithmState &state, int index);
+    static void recordStep(AlgorithmState &state);
+    QVariantMap cellToVariantMap(const SearchGrid& grid, int index, bool inFinalPath) const;  // 简化：只保留最终路径参数
+    int getCell(const SearchGrid& grid, int x, int y) const;
     
-    void debugPrintGrid(const QString& name, const QVector<QVector<Cell>>& grid, const QVector<QPoint>& path) const;
+    void debugPrintGrid(const QString& name, const SearchGrid& grid, const QVector<QPoint>& path) const;
     QVariantMap createDefaultCellData(int x, int y) const;
 };
 
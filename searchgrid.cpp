@@ -0,0 +1,63 @@
+#include "searchgrid.h"
+#include <cstddef>
+
+SearchGrid::SearchGrid(int width, int height)
+    : m_width(width),
+      m_height(height)
+{
+    resetSearch();
+}
+
+SearchGrid::SearchGrid(const SearchGrid &other)
+    : g(other.g),
+      h(other.h),
+      f(other.f),
+      parent(other.parent),
+      flags(other.flags),
+      m_width(other.m_width),
+      m_height(other.m_height)
+{
+}
+
+SearchGrid &SearchGrid::operator=(const SearchGrid &other) {
+    g = other.g;
+    h = other.h;
+    f = other.f;
+    parent = other.parent;
+    flags = other.flags;
+    m_width = other.m_width;
+    m_height = other.m_height;
+    m_touched.clear();
+    m_tracksWrites = false;
+    return *this;
+}
+
+void SearchGrid::setCellState(int index, const CellState &state) {
+    touch(index);
+    g[index] = state.g;
+    h[index] = state.h;
+    f[index] = state.f;
+    parent[index] = state.parent;
+    flags[index] = state.flags;
+}
+
+void SearchGrid::resetSearch() {
+    size_t count = size_t(cellCount());
+    if (m_tracksWrites) {
+        for (int index : m_touched) {
+            g[index] = Unreached;
+            h[index] = 0;
+            f[index] = Unreached;
+            parent[index] = NoParent;
+            flags[index] = 0;
+        }
+    } else {
+        g.assign(count, Unreached);
+        h.assign(count, 0);
+        f.assign(count, Unreached);
+        parent.assign(count, NoParent);
+        flags.assign(count, 0);
+    }
+    m_touched.clear();
+    m_tracksWrites = true;
+}
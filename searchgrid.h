@@ -0,0 +1,90 @@
+#ifndef SEARCHGRID_H
+#define SEARCHGRID_H
+
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// 搜索网格：按行优先顺序连续存储，采用结构体数组布局。
+// g/h/f、父节点索引和开放/关闭标志各自是一段连续数组，障碍物放在单独的 GridMap 位集里，
+// 扩展节点时只会触碰到真正需要的那几条缓存行。
+// 搜索内核在第一次写入某格之前调用 touch()，resetSearch() 只恢复记录过的格子，
+// 同一块网格上的连续查询按写入的格子数清空，而不是按整张地图。
+class SearchGrid {
+public:
+    enum Flag : uint8_t {
+        Open = 0x1,
+        Closed = 0x2
+    };
+
+    static constexpr int Unreached = INT_MAX;
+    static constexpr int NoParent = -1;
+
+    // 单个单元格的搜索状态，用于步骤历史的增量记录
+    struct CellState {
+        int g;
+        int h;
+        int f;
+        int parent;
+        uint8_t flags;
+    };
+
+    SearchGrid() = default;
+    SearchGrid(int width, int height);
+
+    // 副本不带写入记录（步骤历史的关键帧不需要），下次 resetSearch() 整体清空
+    SearchGrid(const SearchGrid &other);
+    SearchGrid &operator=(const SearchGrid &other);
+    SearchGrid(SearchGrid &&) = default;
+    SearchGrid &operator=(SearchGrid &&) = default;
+
+    int width() const { return m_width; }
+    int height() const { return m_height; }
+    int cellCount() const { return m_width * m_height; }
+
+    bool contains(int x, int y) const { return x >= 0 && x < m_width && y >= 0 && y < m_height; }
+    int index(int x, int y) const { return y * m_width + x; }
+    int xOf(int index) const { return index % m_width; }
+    int yOf(int index) const { return index / m_width; }
+
+    bool isOpen(int index) const { return flags[index] & Open; }
+    bool isClosed(int index) const { return flags[index] & Closed; }
+
+    CellState cellState(int index) const { return {g[index], h[index], f[index], parent[index], flags[index]}; }
+    void setCellState(int index, const CellState &state);
+
+    // 写入 index 的任何字段之前调用；g 仍为 Unreached 说明这一格还没有被写过。
+    // 写过的格子超过八分之一时逐格恢复不如顺序重写，停止记录，下次整体清空
+    void touch(int index) {
+        if (!m_tracksWrites || g[index] != Unreached) {
+            return;
+        }
+        if (m_touched.size() >= size_t(cellCount()) / 8) {
+            m_tracksWrites = false;
+            return;
+        }
+        m_touched.push_back(index);
+    }
+
+    // 上次清空以来写过的格子；tracksWrites() 为 false 时记录不完整，不能只按它清空
+    const std::vector<int> &touchedCells() const { return m_touched; }
+    bool tracksWrites() const { return m_tracksWrites; }
+
+    // 清空搜索状态，之后重新开始记录写入
+    void resetSearch();
+
+    std::vector<int> g;
+    std::vector<int> h;
+    std::vector<int> f;
+    std::vector<int> parent;
+    std::vector<uint8_t> flags;
+
+private:
+    int m_width = 0;
+    int m_height = 0;
+    std::vector<int> m_touched;   // 容量跨查询保留，预热后不再分配
+    bool m_tracksWrites = false;
+};
+
+#endif // SEARCHGRID_H
@@ -0,0 +1,123 @@
+#ifndef SEARCHMETRICS_H
+#define SEARCHMETRICS_H
+
+#include <algorithm>
+#include <chrono>
+
+// 编译期开关：ASTAR_METRICS 为 0 时计数和计时都编译成空函数，搜索内核里不留任何额外指令。
+// CMake 选项 ASTAR_METRICS 控制它，默认开启
+#ifndef ASTAR_METRICS
+#define ASTAR_METRICS 1
+#endif
+
+// 一次查询的搜索计数与分阶段耗时。计数在搜索内核的对应位置累加，只是几次整数自增；
+// 耗时用 steady_clock 按阶段累计，每个阶段只在进出时各读一次时钟。
+struct SearchMetrics {
+    static constexpr bool Enabled = ASTAR_METRICS != 0;
+
+    enum Phase {
+        Setup,          // begin()：重置搜索网格、放入起点
+        Search,         // 扩展节点直到结束
+        Reconstruct,    // 回溯路径
+        Record,         // 可视化程序记录步骤历史
+        PhaseCount
+    };
+
+    long long expansions = 0;
+    long long pushes = 0;
+    long long pops = 0;
+    long long decreaseKeys = 0;
+    // 出队时已经关闭的节点。开放集合支持 decrease-key 时总是 0；
+    // 换成重复入队、出队时丢弃旧项的开放集合后，这里就是被丢弃的旧项个数
+    long long stalePops = 0;
+    int peakOpenSize = 0;
+    long long phaseNanoseconds[PhaseCount] = {};
+
+    static const char *phaseName(Phase phase) {
+        switch (phase) {
+        case Setup: return "setup";
+        case Search: return "search";
+        case Reconstruct: return "reconstruct";
+        case Record: return "record";
+        case PhaseCount: break;
+        }
+        return "";
+    }
+
+    void clear() { *this = SearchMetrics(); }
+
+    void expand() {
+#if ASTAR_METRICS
+        ++expansions;
+#endif
+    }
+
+    void push(int openSize) {
+#if ASTAR_METRICS
+        ++pushes;
+        peakOpenSize = std::max(peakOpenSize, openSize);
+#else
+        (void)openSize;
+#endif
+    }
+
+    void pop() {
+#if ASTAR_METRICS
+        ++pops;
+#endif
+    }
+
+    void stalePop() {
+#if ASTAR_METRICS
+        ++stalePops;
+#endif
+    }
+
+    void decreaseKey() {
+#if ASTAR_METRICS
+        ++decreaseKeys;
+#endif
+    }
+
+    double phaseMilliseconds(Phase phase) const { return phaseNanoseconds[phase] / 1e6; }
+
+    // 合并另一份统计（例如双向搜索的两侧）：计数和耗时相加，峰值取较大者
+    void merge(const SearchMetrics &other) {
+        expansions += other.expansions;
+        pushes += other.pushes;
+        pops += other.pops;
+        decreaseKeys += other.decreaseKeys;
+        stalePops += other.stalePops;
+        peakOpenSize = std::max(peakOpenSize, other.peakOpenSize);
+        for (int i = 0; i < PhaseCount; ++i) {
+            phaseNanoseconds[i] += other.phaseNanoseconds[i];
+        }
+    }
+};
+
+// 作用域计时：构造时读时钟，析构时把经过的时间加到指定阶段
+class PhaseTimer {
+public:
+#if ASTAR_METRICS
+    PhaseTimer(SearchMetrics &metrics, SearchMetrics::Phase phase)
+        : m_metrics(metrics), m_phase(phase), m_start(std::chrono::steady_clock::now()) {}
+    ~PhaseTimer() {
+        m_metrics.phaseNanoseconds[m_phase] +=
+            std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - m_start).count();
+    }
+#else
+    PhaseTimer(SearchMetrics &, SearchMetrics::Phase) {}
+#endif
+
+    PhaseTimer(const PhaseTimer &) = delete;
+    PhaseTimer &operator=(const PhaseTimer &) = delete;
+
+#if ASTAR_METRICS
+private:
+    SearchMetrics &m_metrics;
+    SearchMetrics::Phase m_phase;
+    std::chrono::steady_clock::time_point m_start;
+#endif
+};
+
+#endif // SEARCHMETRICS_H
@@ -0,0 +1,145 @@
+#include "workstealingpool.h"
+#include <algorithm>
+
+WorkStealingPool::WorkStealingPool(int threadCount) {
+    if (threadCount <= 0) {
+        threadCount = std::max(1, int(std::thread::hardware_concurrency()));
+    }
+
+    for (int i = 0; i < threadCount; ++i) {
+        m_workers.push_back(std::make_unique<Worker>());
+    }
+    for (int i = 0; i < threadCount; ++i) {
+        m_threads.emplace_back(&WorkStealingPool::workerLoop, this, i);
+    }
+}
+
+WorkStealingPool::~WorkStealingPool() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_wake.notify_all();
+    for (std::thread &thread : m_threads) {
+        thread.join();
+    }
+}
+
+void WorkStealingPool::parallelFor(int count, int grain, const std::function<void(int, int, int)> &body) {
+    if (count <= 0) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> submitLock(m_submitMutex);
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    // 先按线程数均分成连续区间，之后靠窃取来平衡
+    int threads = threadCount();
+    for (int i = 0; i < threads; ++i) {
+        int begin = int(int64_t(count) * i / threads);
+        int end = int(int64_t(count) * (i + 1) / threads);
+        if (begin < end) {
+            std::lock_guard<std::mutex> workerLock(m_workers[i]->mutex);
+            m_workers[i]->ranges.push_back({begin, end});
+        }
+    }
+
+    m_body = &body;
+    m_grain = std::max(1, grain);
+    m_remaining.store(count, std::memory_order_release);
+    m_busy = threads;
+    ++m_generation;
+    m_wake.notify_all();
+
+    m_done.wait(lock, [this] { return m_busy == 0; });
+    m_body = nullptr;
+}
+
+void WorkStealingPool::workerLoop(int worker) {
+    uint64_t seenGeneration = 0;
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_wake.wait(lock, [&] { return m_stop || m_generation != seenGeneration; });
+            if (m_stop) {
+                return;
+            }
+            seenGeneration = m_generation;
+        }
+
+        runJob(worker);
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (--m_busy == 0) {
+            m_done.notify_all();
+        }
+    }
+}
+
+void WorkStealingPool::runJob(int worker) {
+    Range range;
+    while (m_remaining.load(std::memory_order_acquire) > 0) {
+        if (!popLocal(worker, range)) {
+            if (!steal(worker)) {
+                // 剩下的任务都在别的线程手里，等它们做完
+                std::this_thread::yield();
+            }
+            continue;
+        }
+
+        (*m_body)(worker, range.begin, range.end);
+        m_remaining.fetch_sub(range.end - range.begin, std::memory_order_acq_rel);
+    }
+}
+
+bool WorkStealingPool::popLocal(int worker, Range &range) {
+    Worker &self = *m_workers[worker];
+    std::lock_guard<std::mutex> lock(self.mutex);
+    if (self.ranges.empty()) {
+        return false;
+    }
+
+    // 从队尾取 grain 个，剩下的留在队列里供其他线程窃取
+    Range &back = self.ranges.back();
+    if (back.end - back.begin > m_grain) {
+        range = {back.end - m_grain, back.end};
+        back.end -= m_grain;
+    } else {
+        range = back;
+        self.ranges.pop_back();
+    }
+    return true;
+}
+
+bool WorkStealingPool::steal(int worker) {
+    int threads = threadCount();
+    for (int offset = 1; offset < threads; ++offset) {
+        Worker &victim = *m_workers[(worker + offset) % threads];
+        Range range;
+        {
+            std::lock_guard<std::mutex> lock(victim.mutex);
+            if (victim.ranges.empty()) {
+                continue;
+            }
+
+            // 从队首窃取前一半，受害者继续处理后一半
+            Range &front = victim.ranges.front();
+            int size = front.end - front.begin;
+            if (size > m_grain) {
+                int half = std::max(m_grain, size / 2);
+                range = {front.begin, front.begin + half};
+                front.begin += half;
+            } else {
+                range = front;
+                victim.ranges.pop_front();
+            }
+        }
+
+        // 放进自己的队列（不同时持有两把锁），其他空闲线程还可以继续从这里窃取
+        Worker &self = *m_workers[worker];
+        std::lock_guard<std::mutex> lock(self.mutex);
+        self.ranges.push_back(range);
+        return true;
+    }
+    return false;
+}
@@ -0,0 +1,63 @@
+#ifndef WORKSTEALINGPOOL_H
+#define WORKSTEALINGPOOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// 常驻线程池：每个工作线程有自己的任务区间队列，自己从队尾取，
+// 空闲时从其他线程的队首窃取一半，负载不均的批量任务也能均匀分摊到所有核心。
+class WorkStealingPool {
+public:
+    // threadCount 为 0 时使用硬件并发数
+    explicit WorkStealingPool(int threadCount = 0);
+    ~WorkStealingPool();
+
+    WorkStealingPool(const WorkStealingPool &) = delete;
+    WorkStealingPool &operator=(const WorkStealingPool &) = delete;
+
+    int threadCount() const { return int(m_threads.size()); }
+
+    // 把 [0, count) 分给各工作线程处理，每次至少 grain 个元素，阻塞到全部完成。
+    // body(worker, begin, end) 中的 worker 是 [0, threadCount) 内的线程编号，
+    // 调用方可以用它索引每个线程独占的暂存数据。
+    void parallelFor(int count, int grain, const std::function<void(int, int, int)> &body);
+
+private:
+    struct Range {
+        int begin;
+        int end;
+    };
+
+    struct Worker {
+        std::mutex mutex;
+        std::deque<Range> ranges;
+    };
+
+    void workerLoop(int worker);
+    void runJob(int worker);
+    bool popLocal(int worker, Range &range);
+    bool steal(int worker);
+
+    std::vector<std::thread> m_threads;
+    std::vector<std::unique_ptr<Worker>> m_workers;
+
+    std::mutex m_submitMutex;   // 同一时间只运行一个 parallelFor
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    std::condition_variable m_done;
+    const std::function<void(int, int, int)> *m_body = nullptr;
+    int m_grain = 1;
+    uint64_t m_generation = 0;
+    int m_busy = 0;
+    bool m_stop = false;
+    std::atomic<int> m_remaining{0};
+};
+
+#endif // WORKSTEALINGPOOL_H